@@ -0,0 +1,125 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// a minimal timing harness for the benchmark targets, each case reports the best ns / op over a few
+// samples as a json line (default) or a csv row
+namespace bench {
+    // keep the optimizer from discarding a result
+    template <typename T> inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    enum class output_format : uint8_t { _json, _csv };
+
+    struct result {
+        std::string name;      // operation
+        std::string container; // container under test
+        std::string element;   // element type
+        size_t      capacity;
+        size_t      ops;       // operations per sample
+        double      ns_per_op; // best sample
+        double      ns_median; // median sample
+    };
+
+    struct options {
+        output_format format      = output_format::_json;
+        size_t        samples     = 15;
+        double        min_time_ms = 2.0; // per sample
+        std::string   filter      = "";  // only run cases whose name contains this
+
+        static options parse(int argc, char **argv) {
+            options opts;
+            for (int i = 1; i < argc; i++) {
+                const char *arg = argv[i];
+                if (std::strcmp(arg, "--csv") == 0) {
+                    opts.format = output_format::_csv;
+                } else if (std::strcmp(arg, "--json") == 0) {
+                    opts.format = output_format::_json;
+                } else if (std::strncmp(arg, "--samples=", 10) == 0) {
+                    opts.samples = std::max<size_t>(1, std::stoull(arg + 10));
+                } else if (std::strncmp(arg, "--min-time-ms=", 14) == 0) {
+                    opts.min_time_ms = std::stod(arg + 14);
+                } else if (std::strncmp(arg, "--filter=", 9) == 0) {
+                    opts.filter = arg + 9;
+                } else {
+                    std::cerr << "usage: " << argv[0]
+                              << " [--json|--csv] [--samples=N] [--min-time-ms=MS] [--filter=TEXT]\n";
+                    std::exit(1);
+                }
+            }
+            return opts;
+        }
+    };
+
+    class runner {
+        options _opts;
+        bool    _header_done = false;
+
+        void report(const result &res) {
+            if (_opts.format == output_format::_csv) {
+                if (!_header_done) {
+                    std::cout << "name,container,element,capacity,ops,ns_per_op,ns_median\n";
+                    _header_done = true;
+                }
+                std::cout << res.name << "," << res.container << "," << res.element << "," << res.capacity
+                          << "," << res.ops << "," << res.ns_per_op << "," << res.ns_median << "\n";
+            } else {
+                std::cout << "{\"name\":\"" << res.name << "\",\"container\":\"" << res.container
+                          << "\",\"element\":\"" << res.element << "\",\"capacity\":" << res.capacity
+                          << ",\"ops\":" << res.ops << ",\"ns_per_op\":" << res.ns_per_op
+                          << ",\"ns_median\":" << res.ns_median << "}\n";
+            }
+        }
+
+      public:
+        explicit runner(options opts) : _opts(std::move(opts)) {
+        }
+
+        bool selected(const std::string &name) const {
+            return _opts.filter.empty() || name.find(_opts.filter) != std::string::npos;
+        }
+
+        // fn runs ops operations per call, it is repeated until a sample takes at least min_time_ms
+        template <typename Fn>
+        void run(const std::string &name, const std::string &container, const std::string &element,
+                 size_t capacity, size_t ops, Fn &&fn) {
+            if (!selected(name))
+                return;
+            using clock = std::chrono::steady_clock;
+            // warm up and find the repetition count
+            size_t reps = 1;
+            for (;;) {
+                auto start = clock::now();
+                for (size_t r = 0; r < reps; r++)
+                    fn();
+                double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+                if (ms >= _opts.min_time_ms || reps >= (size_t(1) << 30))
+                    break;
+                reps *= 2;
+            }
+
+            std::vector<double> sample_ns;
+            sample_ns.reserve(_opts.samples);
+            for (size_t s = 0; s < _opts.samples; s++) {
+                auto start = clock::now();
+                for (size_t r = 0; r < reps; r++)
+                    fn();
+                double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+                sample_ns.push_back(ns / double(reps * (ops ? ops : 1)));
+            }
+            std::sort(sample_ns.begin(), sample_ns.end());
+            report({name, container, element, capacity, ops, sample_ns.front(), sample_ns[sample_ns.size() / 2]});
+        }
+    };
+} // namespace bench
@@ -0,0 +1,74 @@
+// flat_map_bench.cpp : lookups and builds of stack_flat_map against std::map and std::unordered_map for
+// small tables, half the probes hit and half miss
+//
+#include "bench.h"
+#include "flat_map.h"
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+template <typename Map> void run_map(bench::runner &runner, const char *container, const Map &map,
+                                     const std::vector<uint32_t> &probes, size_t capacity) {
+    runner.run("find", container, "uint32", capacity, probes.size(), [&] {
+        uint32_t sum = 0;
+        for (uint32_t probe : probes) {
+            auto it = map.find(probe);
+            sum += it != map.end() ? it->second : 0;
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+template <size_t N> void run_size(bench::runner &runner) {
+    std::mt19937          gen{uint32_t(N)};
+    std::vector<uint32_t> keys;
+    for (size_t i = 0; i < N; i++) {
+        keys.push_back(gen() & ~1u); // even keys are present, odd probes miss
+    }
+    std::vector<uint32_t> probes;
+    for (size_t i = 0; i < 1024; i++) {
+        probes.push_back(keys[gen() % N] | (gen() & 1u));
+    }
+
+    stack_vector::stack_flat_map<uint32_t, uint32_t, N> flat;
+    std::map<uint32_t, uint32_t>                       tree;
+    std::unordered_map<uint32_t, uint32_t>             hash;
+    for (uint32_t key : keys) {
+        flat.try_emplace(key, key);
+        tree.try_emplace(key, key);
+        hash.try_emplace(key, key);
+    }
+    run_map(runner, "stack_flat_map", flat, probes, N);
+    run_map(runner, "std_map", tree, probes, N);
+    run_map(runner, "std_unordered_map", hash, probes, N);
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (uint32_t key : keys) {
+        pairs.emplace_back(key, key);
+    }
+    runner.run("build", "stack_flat_map", "uint32", N, N, [&] {
+        stack_vector::stack_flat_map<uint32_t, uint32_t, N> built(pairs.begin(), pairs.end());
+        bench::do_not_optimize(built);
+    });
+    runner.run("build", "std_map", "uint32", N, N, [&] {
+        std::map<uint32_t, uint32_t> built(pairs.begin(), pairs.end());
+        bench::do_not_optimize(built);
+    });
+    runner.run("build", "std_unordered_map", "uint32", N, N, [&] {
+        std::unordered_map<uint32_t, uint32_t> built(pairs.begin(), pairs.end());
+        bench::do_not_optimize(built);
+    });
+}
+
+int main(int argc, char **argv) {
+    bench::runner runner(bench::options::parse(argc, argv));
+    run_size<8>(runner);
+    run_size<16>(runner);
+    run_size<32>(runner);
+    run_size<64>(runner);
+    run_size<128>(runner);
+    run_size<256>(runner);
+    return 0;
+}
@@ -0,0 +1,122 @@
+// relocation_bench.cpp : front / middle insertion and erasure for trivially relocatable element types
+// against the same types with user provided copies and moves (the per element path)
+//
+#include "stack_vector.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+template <size_t Bytes> struct payload {
+    uint64_t words[Bytes / sizeof(uint64_t)];
+
+    explicit payload(uint64_t value = 0) {
+        for (auto &word : words)
+            word = value;
+    }
+};
+
+// same bytes, but neither trivially copyable nor trivially relocatable
+template <size_t Bytes> struct opaque_payload {
+    uint64_t words[Bytes / sizeof(uint64_t)];
+
+    explicit opaque_payload(uint64_t value = 0) {
+        for (auto &word : words)
+            word = value;
+    }
+    opaque_payload(const opaque_payload &other) {
+        for (size_t i = 0; i < std::size(words); i++)
+            words[i] = other.words[i];
+    }
+    opaque_payload &operator=(const opaque_payload &other) {
+        for (size_t i = 0; i < std::size(words); i++)
+            words[i] = other.words[i];
+        return *this;
+    }
+    ~opaque_payload() {
+    }
+};
+
+// a move only handle, opted in below
+struct handle {
+    uint64_t *ptr   = nullptr;
+    uint64_t  extra = 0;
+
+    explicit handle(uint64_t value = 0) : extra(value) {
+    }
+    handle(handle &&other) noexcept : ptr(other.ptr), extra(other.extra) {
+        other.ptr = nullptr;
+    }
+    handle &operator=(handle &&other) noexcept {
+        std::swap(ptr, other.ptr);
+        extra = other.extra;
+        return *this;
+    }
+    ~handle() {
+        delete ptr;
+    }
+};
+struct opaque_handle : handle {
+    using handle::handle;
+};
+template <> struct stack_vector::is_trivially_relocatable<handle> : std::true_type {};
+
+constexpr size_t capacity = 128;
+
+template <typename Fn> double best_ns(size_t repeats, size_t ops, Fn &&fn) {
+    double best = 1e300;
+    for (size_t r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto stop = std::chrono::steady_clock::now();
+        best      = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    return best / double(ops);
+}
+
+template <typename T> void run(const char *name, size_t repeats) {
+    using vector_type = stack_vector::stack_vector<T, capacity>;
+    uint64_t sink     = 0;
+
+    double emplace_front = best_ns(repeats, capacity, [&] {
+        vector_type vec;
+        for (size_t i = 0; i < capacity; i++)
+            vec.emplace(vec.begin(), i);
+        sink += vec.size();
+    });
+    double erase_front = best_ns(repeats, capacity, [&] {
+        vector_type vec;
+        for (size_t i = 0; i < capacity; i++)
+            vec.emplace_back(i);
+        while (!vec.empty())
+            vec.erase(vec.begin());
+        sink += vec.size();
+    });
+    double erase_middle_range = best_ns(repeats, capacity / 4, [&] {
+        vector_type vec;
+        for (size_t i = 0; i < capacity; i++)
+            vec.emplace_back(i);
+        while (vec.size() >= 4)
+            vec.erase(vec.begin() + vec.size() / 2 - 2, vec.begin() + vec.size() / 2 + 2);
+        sink += vec.size();
+    });
+
+    volatile uint64_t keep = sink;
+    (void)keep;
+    std::cout << name << "," << sizeof(T) << "," << stack_vector::is_trivially_relocatable_v<T> << ","
+              << emplace_front << "," << erase_front << "," << erase_middle_range << "\n";
+}
+
+int main(int argc, char **argv) {
+    size_t repeats = argc > 1 ? std::stoull(argv[1]) : 2000;
+
+    std::cout << "type,sizeof,relocatable,emplace_front_ns,erase_front_ns,erase_middle_range_ns\n";
+    run<payload<16>>("payload_16", repeats);
+    run<opaque_payload<16>>("opaque_payload_16", repeats);
+    run<payload<32>>("payload_32", repeats);
+    run<opaque_payload<32>>("opaque_payload_32", repeats);
+    run<payload<64>>("payload_64", repeats);
+    run<opaque_payload<64>>("opaque_payload_64", repeats);
+    run<handle>("handle_16", repeats);
+    run<opaque_handle>("opaque_handle_16", repeats);
+    return 0;
+}
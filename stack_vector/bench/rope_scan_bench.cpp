@@ -0,0 +1,84 @@
+// rope_scan_bench.cpp : full scans over rope and block_rope, element iterators against the segment wise
+// algorithms, with a std::vector of the same elements as the contiguous baseline. Building a block_rope
+// and reducing over it are also timed on one thread against every hardware thread.
+//
+#include "bench.h"
+#include "rope_parallel.h"
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+template <typename R>
+void run_scans(bench::runner &runner, const char *container, const R &r, const std::vector<uint32_t> &out_buffer,
+               size_t count) {
+    std::vector<uint32_t> out = out_buffer;
+
+    runner.run("accumulate_iterator", container, "uint32", count, count, [&] {
+        bench::do_not_optimize(std::accumulate(r.begin(), r.end(), uint64_t(0)));
+    });
+    runner.run("accumulate_segments", container, "uint32", count, count, [&] {
+        bench::do_not_optimize(rope::accumulate(r, uint64_t(0)));
+    });
+    runner.run("count_iterator", container, "uint32", count, count, [&] {
+        bench::do_not_optimize(std::count(r.begin(), r.end(), uint32_t(7)));
+    });
+    runner.run("count_segments", container, "uint32", count, count, [&] {
+        bench::do_not_optimize(rope::count(r, uint32_t(7)));
+    });
+    runner.run("copy_iterator", container, "uint32", count, count, [&] {
+        std::copy(r.begin(), r.end(), out.begin());
+        bench::do_not_optimize(out);
+    });
+    runner.run("copy_segments", container, "uint32", count, count, [&] {
+        rope::copy(r, out.begin());
+        bench::do_not_optimize(out);
+    });
+}
+
+template <size_t N> void run_size(bench::runner &runner) {
+    std::vector<uint32_t>            vec(N);
+    rope::rope<uint32_t>             chunked;
+    rope::block_rope<uint32_t, 1024> blocked;
+    for (size_t i = 0; i < N; i++) {
+        vec[i] = uint32_t(i * 2654435761u);
+        chunked.push_back(vec[i]);
+        blocked.push_back(vec[i]);
+    }
+    std::vector<uint32_t> out(N);
+
+    runner.run("accumulate", "std_vector", "uint32", N, N, [&] {
+        bench::do_not_optimize(std::accumulate(vec.begin(), vec.end(), uint64_t(0)));
+    });
+    runner.run("count", "std_vector", "uint32", N, N, [&] {
+        bench::do_not_optimize(std::count(vec.begin(), vec.end(), uint32_t(7)));
+    });
+    runner.run("copy", "std_vector", "uint32", N, N, [&] {
+        std::copy(vec.begin(), vec.end(), out.begin());
+        bench::do_not_optimize(out);
+    });
+    run_scans(runner, "rope", chunked, out, N);
+    run_scans(runner, "block_rope_1024", blocked, out, N);
+
+    runner.run("build_emplace_back", "block_rope_1024", "uint32", N, N, [&] {
+        rope::block_rope<uint32_t, 1024> built;
+        for (size_t i = 0; i < N; i++)
+            built.emplace_back(uint32_t(i * 2654435761u));
+        bench::do_not_optimize(built);
+    });
+    runner.run("build_parallel", "block_rope_1024", "uint32", N, N, [&] {
+        rope::block_rope<uint32_t, 1024> built;
+        rope::parallel_append_n(built, N, [](size_t i) { return uint32_t(i * 2654435761u); });
+        bench::do_not_optimize(built);
+    });
+    runner.run("reduce_parallel", "block_rope_1024", "uint32", N, N, [&] {
+        bench::do_not_optimize(rope::parallel_reduce(blocked, uint64_t(0)));
+    });
+}
+
+int main(int argc, char **argv) {
+    bench::runner runner(bench::options::parse(argc, argv));
+    run_size<(1 << 16)>(runner);
+    run_size<(1 << 22)>(runner);
+    return 0;
+}
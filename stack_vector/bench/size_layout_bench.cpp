@@ -0,0 +1,93 @@
+// size_layout_bench.cpp : dense arrays of small stack_vectors, with the old size_t counter and the
+// capacity sized counter in front of or behind the elements
+//
+#include "stack_vector.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// the layout before the size counter was sized to the capacity
+template <typename T, size_t N> struct legacy_stack_vector {
+    size_t           _size = 0;
+    std::array<T, N> store;
+
+    constexpr size_t size() const noexcept {
+        return _size;
+    }
+    constexpr void shove_back(const T &value) {
+        store[_size++] = value;
+    }
+    constexpr const T *begin() const noexcept {
+        return store.data();
+    }
+    constexpr const T *end() const noexcept {
+        return store.data() + _size;
+    }
+};
+
+struct bench_result {
+    double scan_ns_per_vector;
+    double size_ns_per_vector;
+};
+
+template <typename Vector> bench_result run_bench(size_t count, size_t repeats) {
+    std::vector<Vector> vectors(count);
+    std::mt19937        rng(1234);
+    for (auto &vec : vectors) {
+        size_t fill = rng() % 16;
+        for (size_t i = 0; i < fill; i++)
+            vec.shove_back(uint8_t(rng()));
+    }
+
+    // every element of every vector
+    double   best_scan = 1e300;
+    uint64_t sink      = 0;
+    for (size_t r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &vec : vectors) {
+            for (auto value : vec)
+                sink += value;
+        }
+        auto stop = std::chrono::steady_clock::now();
+        best_scan = std::min(best_scan, std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    // only the size counters, bound by how many vectors fit in a cache line
+    double best_size = 1e300;
+    for (size_t r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &vec : vectors)
+            sink += vec.size();
+        auto stop = std::chrono::steady_clock::now();
+        best_size = std::min(best_size, std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    volatile uint64_t keep = sink;
+    (void)keep;
+    return {best_scan / double(count), best_size / double(count)};
+}
+
+template <typename Vector> void print_bench(const char *name, size_t count, size_t repeats) {
+    bench_result result = run_bench<Vector>(count, repeats);
+    std::cout << name << "," << sizeof(Vector) << "," << result.scan_ns_per_vector << ","
+              << result.size_ns_per_vector << "\n";
+}
+
+int main(int argc, char **argv) {
+    size_t count   = argc > 1 ? std::stoull(argv[1]) : (1u << 22);
+    size_t repeats = argc > 2 ? std::stoull(argv[2]) : 10;
+
+    using legacy = legacy_stack_vector<uint8_t, 15>;
+    using before = stack_vector::stack_vector<uint8_t, 15, stack_vector::size_layout::_before>;
+    using after  = stack_vector::stack_vector<uint8_t, 15, stack_vector::size_layout::_after>;
+    static_assert(sizeof(legacy) == 24);
+    static_assert(sizeof(before) == 16);
+    static_assert(sizeof(after) == 16);
+
+    std::cout << "layout,sizeof,scan_ns_per_vector,size_ns_per_vector\n";
+    print_bench<legacy>("size_t_before", count, repeats);
+    print_bench<before>("uint8_t_before", count, repeats);
+    print_bench<after>("uint8_t_after", count, repeats);
+    return 0;
+}
@@ -0,0 +1,252 @@
+// spsc_queue_bench.cpp : spsc_queue between two threads (pinned to two cores where the platform allows),
+// against a mutex guarded std::vector. Throughput is ops / sec over a long transfer, latency is the
+// percentiles of a ping pong round trip through a pair of queues.
+//
+#include "bench.h"
+#include "spsc_queue.h"
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+static void pin_to_core(unsigned core) {
+#if defined(__linux__)
+    const unsigned cores = std::thread::hardware_concurrency();
+    if (cores < 2)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+// busy waiting only makes sense with a core for each side, otherwise hand over the time slice
+static const bool single_core = std::thread::hardware_concurrency() < 2;
+static void wait_a_bit() {
+    if (single_core)
+        std::this_thread::yield();
+}
+
+// what gets used today, a vector swapped out under a lock
+template <typename T> struct mutex_queue {
+    std::mutex     lock;
+    std::vector<T> items;
+    size_t         read = 0;
+    size_t         capacity;
+
+    explicit mutex_queue(size_t cap) : capacity(cap) {
+        items.reserve(cap);
+    }
+    bool try_push(const T &value) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (items.size() - read >= capacity)
+            return false;
+        if (read && read == items.size()) {
+            items.clear();
+            read = 0;
+        }
+        items.push_back(value);
+        return true;
+    }
+    bool try_pop(T &out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (read == items.size())
+            return false;
+        out = items[read++];
+        return true;
+    }
+};
+
+static void print(const bench::options &opts, const std::string &name, const std::string &container,
+                  const std::vector<std::pair<const char *, double>> &fields) {
+    if (opts.format == bench::output_format::_csv) {
+        std::cout << name << "," << container;
+        for (const auto &field : fields)
+            std::cout << "," << field.first << "=" << field.second;
+        std::cout << "\n";
+    } else {
+        std::cout << "{\"name\":\"" << name << "\",\"container\":\"" << container << "\"";
+        for (const auto &field : fields)
+            std::cout << ",\"" << field.first << "\":" << field.second;
+        std::cout << "}\n";
+    }
+}
+
+constexpr size_t queue_size = 1024;
+constexpr size_t batch_size = 32;
+
+// runs push (producer side, pinned to core 1) against pop (this thread, core 0) for total values, returns ns
+template <typename Push, typename Pop> double transfer(uint64_t total, Push push, Pop pop) {
+    using clock = std::chrono::steady_clock;
+    auto        start = clock::now();
+    std::thread producer([&] {
+        pin_to_core(1);
+        push(total);
+    });
+    pop(total);
+    producer.join();
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+}
+
+template <typename Fn> void report_transfer(const bench::options &opts, const char *container, uint64_t total, Fn fn) {
+    std::vector<double> ns;
+    for (size_t s = 0; s < std::max<size_t>(3, opts.samples / 3); s++)
+        ns.push_back(fn(total));
+    std::sort(ns.begin(), ns.end());
+    print(opts, "transfer", container,
+          {{"ops", double(total)},
+           {"ns_per_op", ns.front() / double(total)},
+           {"ops_per_sec", double(total) * 1e9 / ns.front()},
+           {"ns_median", ns[ns.size() / 2] / double(total)}});
+}
+
+void run_throughput(const bench::options &opts) {
+    constexpr uint64_t total = uint64_t(1) << 22;
+
+    report_transfer(opts, "spsc_queue", total, [](uint64_t count) {
+        auto queue = std::make_unique<stack_vector::spsc_queue<uint64_t, queue_size>>();
+        return transfer(
+            count,
+            [&](uint64_t n) {
+                for (uint64_t i = 0; i < n;) {
+                    if (queue->try_push(i))
+                        i++;
+                    else
+                        wait_a_bit();
+                }
+            },
+            [&](uint64_t n) {
+                uint64_t sum = 0, value = 0;
+                for (uint64_t i = 0; i < n;) {
+                    if (queue->try_pop(value)) {
+                        sum += value;
+                        i++;
+                    } else {
+                        wait_a_bit();
+                    }
+                }
+                bench::do_not_optimize(sum);
+            });
+    });
+
+    report_transfer(opts, "spsc_queue_batch_32", total, [](uint64_t count) {
+        auto queue = std::make_unique<stack_vector::spsc_queue<uint64_t, queue_size>>();
+        return transfer(
+            count,
+            [&](uint64_t n) {
+                uint64_t chunk[batch_size];
+                for (uint64_t i = 0; i < n;) {
+                    const size_t want = size_t(std::min<uint64_t>(batch_size, n - i));
+                    for (size_t k = 0; k < want; k++)
+                        chunk[k] = i + k;
+                    const size_t pushed = queue->try_push_n(chunk, want);
+                    i += pushed;
+                    if (!pushed)
+                        wait_a_bit();
+                }
+            },
+            [&](uint64_t n) {
+                uint64_t sum = 0, chunk[batch_size];
+                for (uint64_t i = 0; i < n;) {
+                    const size_t got = queue->try_pop_n(chunk, batch_size);
+                    for (size_t k = 0; k < got; k++)
+                        sum += chunk[k];
+                    i += got;
+                    if (!got)
+                        wait_a_bit();
+                }
+                bench::do_not_optimize(sum);
+            });
+    });
+
+    report_transfer(opts, "mutex_vector", total, [](uint64_t count) {
+        mutex_queue<uint64_t> queue(queue_size);
+        return transfer(
+            count,
+            [&](uint64_t n) {
+                for (uint64_t i = 0; i < n;) {
+                    if (queue.try_push(i))
+                        i++;
+                    else
+                        wait_a_bit();
+                }
+            },
+            [&](uint64_t n) {
+                uint64_t sum = 0, value = 0;
+                for (uint64_t i = 0; i < n;) {
+                    if (queue.try_pop(value)) {
+                        sum += value;
+                        i++;
+                    } else {
+                        wait_a_bit();
+                    }
+                }
+                bench::do_not_optimize(sum);
+            });
+    });
+}
+
+// one value goes out through ping and straight back through pong, each round trip is timed on its own
+template <typename Make> void report_round_trip(const bench::options &opts, const char *container, Make make) {
+    using clock                 = std::chrono::steady_clock;
+    constexpr size_t round_trips = 200000;
+    auto             ping        = make();
+    auto             pong        = make();
+
+    std::thread echo([&] {
+        pin_to_core(1);
+        uint64_t value = 0;
+        for (size_t i = 0; i < round_trips; i++) {
+            while (!ping->try_pop(value)) {
+                wait_a_bit();
+            }
+            while (!pong->try_push(value)) {
+                wait_a_bit();
+            }
+        }
+    });
+    std::vector<double> ns;
+    ns.reserve(round_trips);
+    uint64_t value = 0;
+    for (size_t i = 0; i < round_trips; i++) {
+        auto start = clock::now();
+        while (!ping->try_push(uint64_t(i))) {
+            wait_a_bit();
+        }
+        while (!pong->try_pop(value)) {
+            wait_a_bit();
+        }
+        ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+    }
+    echo.join();
+    std::sort(ns.begin(), ns.end());
+    auto percentile = [&](double p) { return ns[std::min(ns.size() - 1, size_t(p * double(ns.size())))]; };
+    print(opts, "round_trip", container,
+          {{"ops", double(round_trips)},
+           {"p50_ns", percentile(0.50)},
+           {"p90_ns", percentile(0.90)},
+           {"p99_ns", percentile(0.99)},
+           {"p999_ns", percentile(0.999)},
+           {"max_ns", ns.back()}});
+}
+
+int main(int argc, char **argv) {
+    const bench::options opts = bench::options::parse(argc, argv);
+    pin_to_core(0);
+    bench::runner runner(opts);
+    if (runner.selected("transfer"))
+        run_throughput(opts);
+    if (runner.selected("round_trip")) {
+        report_round_trip(opts, "spsc_queue", [] {
+            return std::make_unique<stack_vector::spsc_queue<uint64_t, queue_size>>();
+        });
+        report_round_trip(opts, "mutex_vector", [] {
+            return std::make_unique<mutex_queue<uint64_t>>(queue_size);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,424 @@
+// stack_vector_bench.cpp : hot path timings for stack_vector against std::vector (with reserve), a
+// std::array plus a counter, and boost's static_vector when it is available
+//
+#include "bench.h"
+#include "slot_map.h"
+#include "stack_deque.h"
+#include "stack_vector.h"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#if __has_include(<boost/container/static_vector.hpp>)
+#include <boost/container/static_vector.hpp>
+#define STACK_VECTOR_BENCH_BOOST 1
+#endif
+
+struct pod64 {
+    uint64_t words[8];
+
+    bool operator==(const pod64 &) const = default;
+    bool operator<(const pod64 &other) const {
+        return words[0] < other.words[0];
+    }
+};
+
+template <typename T> T make_value(size_t i);
+template <> int make_value<int>(size_t i) {
+    return int(i * 2654435761u);
+}
+template <> pod64 make_value<pod64>(size_t i) {
+    pod64 ret;
+    for (auto &word : ret.words)
+        word = i++;
+    return ret;
+}
+template <> std::string make_value<std::string>(size_t i) {
+    // short enough to stay in the small string buffer
+    return "key_" + std::to_string(i);
+}
+
+size_t key_of(int value) {
+    return size_t(value);
+}
+size_t key_of(const pod64 &value) {
+    return size_t(value.words[0]);
+}
+size_t key_of(const std::string &value) {
+    return value.size() + size_t(value.back());
+}
+
+// a std::array plus a counter, the hand rolled alternative
+template <typename T, size_t N> struct array_vector {
+    using value_type = T;
+
+    std::array<T, N> store{};
+    size_t           count = 0;
+
+    T *begin() {
+        return store.data();
+    }
+    T *end() {
+        return store.data() + count;
+    }
+    const T *begin() const {
+        return store.data();
+    }
+    const T *end() const {
+        return store.data() + count;
+    }
+    size_t size() const {
+        return count;
+    }
+    void clear() {
+        count = 0;
+    }
+    void push_back(const T &value) {
+        store[count++] = value;
+    }
+    template <typename It> void insert(T *, It first, It last) {
+        for (; first != last; ++first)
+            store[count++] = *first;
+    }
+    T *insert(T *pos, const T &value) {
+        std::move_backward(pos, end(), end() + 1);
+        *pos = value;
+        count++;
+        return pos;
+    }
+    T *erase(T *pos) {
+        std::move(pos + 1, end(), pos);
+        count--;
+        return pos;
+    }
+    T *erase(T *first, T *last) {
+        std::move(last, end(), first);
+        count -= size_t(last - first);
+        return first;
+    }
+    void swap(array_vector &other) {
+        std::swap(store, other.store);
+        std::swap(count, other.count);
+    }
+};
+
+// std::erase_if where there is one, remove_if then erase otherwise
+template <typename C, typename Pred> size_t erase_if_of(C &c, Pred pred) {
+    if constexpr (requires { std::erase_if(c, pred); }) {
+        return std::erase_if(c, pred);
+    } else {
+        auto   it      = std::remove_if(c.begin(), c.end(), pred);
+        size_t removed = size_t(c.end() - it);
+        c.erase(it, c.end());
+        return removed;
+    }
+}
+
+// std::erase where there is one, remove then erase otherwise
+template <typename C, typename T> size_t erase_of(C &c, const T &value) {
+    if constexpr (requires { std::erase(c, value); }) {
+        return std::erase(c, value);
+    } else {
+        auto   it      = std::remove(c.begin(), c.end(), value);
+        size_t removed = size_t(c.end() - it);
+        c.erase(it, c.end());
+        return removed;
+    }
+}
+
+// stack_vector's own count where it has one
+template <typename C, typename T> size_t count_of(const C &c, const T &value) {
+    if constexpr (requires { stack_vector::count(c, value); })
+        return stack_vector::count(c, value);
+    else
+        return size_t(std::count(c.begin(), c.end(), value));
+}
+
+template <typename C> struct container_traits;
+template <typename T, size_t N> struct container_traits<stack_vector::stack_vector<T, N>> {
+    static constexpr const char *name     = "stack_vector";
+    static constexpr bool        is_stack = true;
+};
+template <typename T> struct container_traits<std::vector<T>> {
+    static constexpr const char *name     = "std_vector_reserve";
+    static constexpr bool        is_stack = false;
+};
+template <typename T, size_t N> struct container_traits<array_vector<T, N>> {
+    static constexpr const char *name     = "std_array_counter";
+    static constexpr bool        is_stack = false;
+};
+#if STACK_VECTOR_BENCH_BOOST
+template <typename T, size_t N> struct container_traits<boost::container::static_vector<T, N>> {
+    static constexpr const char *name     = "boost_static_vector";
+    static constexpr bool        is_stack = false;
+};
+#endif
+
+template <typename C, size_t N> C make_container() {
+    C c;
+    if constexpr (std::is_same<C, std::vector<typename C::value_type>>::value)
+        c.reserve(N);
+    return c;
+}
+
+template <typename C, typename T> void fill_to(C &c, const std::vector<T> &src, size_t count) {
+    c.clear();
+    for (size_t i = 0; i < count; i++)
+        c.push_back(src[i]);
+}
+
+template <typename C, typename T, size_t N>
+void run_container(bench::runner &runner, const char *element_name) {
+    const char *container = container_traits<C>::name;
+
+    std::vector<T> src;
+    for (size_t i = 0; i < N; i++)
+        src.push_back(make_value<T>(i));
+    bool (*is_odd)(const T &) = [](const T &value) { return (key_of(value) & 1) != 0; };
+
+    C c = make_container<C, N>();
+
+    runner.run("push_back", container, element_name, N, N, [&] {
+        c.clear();
+        for (size_t i = 0; i < N; i++)
+            c.push_back(src[i]);
+        bench::do_not_optimize(c);
+    });
+    if constexpr (container_traits<C>::is_stack) {
+        runner.run("shove_back", container, element_name, N, N, [&] {
+            c.clear();
+            for (size_t i = 0; i < N; i++)
+                c.shove_back(src[i]);
+            bench::do_not_optimize(c);
+        });
+        runner.run("unchecked_emplace_back", container, element_name, N, N, [&] {
+            c.clear();
+            for (size_t i = 0; i < N; i++)
+                c.unchecked_emplace_back(src[i]);
+            bench::do_not_optimize(c);
+        });
+        runner.run("append", container, element_name, N, N, [&] {
+            c.clear();
+            c.append(src.begin(), src.end());
+            bench::do_not_optimize(c);
+        });
+    } else {
+        runner.run("append", container, element_name, N, N, [&] {
+            c.clear();
+            c.insert(c.end(), src.begin(), src.end());
+            bench::do_not_optimize(c);
+        });
+    }
+
+    // fill half, then insert the other half at the given spot (the refill is part of each op)
+    auto insert_case = [&](const char *name, auto where) {
+        runner.run(name, container, element_name, N, N / 2, [&] {
+            fill_to(c, src, N / 2);
+            for (size_t i = N / 2; i < N; i++)
+                c.insert(where(c), src[i]);
+            bench::do_not_optimize(c);
+        });
+    };
+    insert_case("insert_front", [](C &v) { return v.begin(); });
+    insert_case("insert_middle", [](C &v) { return v.begin() + v.size() / 2; });
+    insert_case("insert_back", [](C &v) { return v.end(); });
+    runner.run("insert_range_middle", container, element_name, N, N / 2, [&] {
+        fill_to(c, src, N / 2);
+        c.insert(c.begin() + N / 4, src.begin() + N / 2, src.end());
+        bench::do_not_optimize(c);
+    });
+
+    runner.run("erase_middle", container, element_name, N, N, [&] {
+        fill_to(c, src, N);
+        while (c.size())
+            c.erase(c.begin() + c.size() / 2);
+        bench::do_not_optimize(c);
+    });
+
+    fill_to(c, src, N / 2);
+    runner.run("copy_half_full", container, element_name, N, 1, [&] {
+        C copy = c;
+        bench::do_not_optimize(copy);
+    });
+
+    C other = make_container<C, N>();
+    fill_to(other, src, N / 4);
+    runner.run("swap_half_quarter_full", container, element_name, N, 1, [&] {
+        c.swap(other);
+        bench::do_not_optimize(c);
+        bench::do_not_optimize(other);
+    });
+
+    runner.run("erase_if_refill", container, element_name, N, N, [&] {
+        fill_to(c, src, N);
+        bench::do_not_optimize(erase_if_of(c, is_odd));
+    });
+
+    runner.run("erase_value_refill", container, element_name, N, N, [&] {
+        fill_to(c, src, N);
+        bench::do_not_optimize(erase_of(c, src[N / 2]));
+    });
+
+    fill_to(c, src, N);
+    runner.run("count", container, element_name, N, N, [&] {
+        bench::do_not_optimize(count_of(c, src[N / 2]));
+    });
+    runner.run("iterate", container, element_name, N, N, [&] {
+        size_t sum = 0;
+        for (const auto &value : c)
+            sum += key_of(value);
+        bench::do_not_optimize(sum);
+    });
+}
+
+// a full sliding window, each op drops the oldest element and pushes a new one
+template <typename T, size_t N> void run_fifo(bench::runner &runner, const char *element_name) {
+    std::vector<T> src;
+    for (size_t i = 0; i < N; i++)
+        src.push_back(make_value<T>(i));
+
+    stack_vector::stack_vector<T, N> vec;
+    fill_to(vec, src, N);
+    runner.run("fifo_window", "stack_vector", element_name, N, N, [&] {
+        for (size_t i = 0; i < N; i++) {
+            vec.erase(vec.begin());
+            vec.push_back(src[i]);
+        }
+        bench::do_not_optimize(vec);
+    });
+
+    stack_vector::stack_deque<T, N> deque;
+    for (size_t i = 0; i < N; i++)
+        deque.push_back(src[i]);
+    runner.run("fifo_window", "stack_deque", element_name, N, N, [&] {
+        for (size_t i = 0; i < N; i++) {
+            deque.pop_front();
+            deque.push_back(src[i]);
+        }
+        bench::do_not_optimize(deque);
+    });
+}
+
+// a full container, each op drops an element from the middle and adds a new one
+template <typename T, size_t N> void run_churn(bench::runner &runner, const char *element_name) {
+    std::vector<T> src;
+    for (size_t i = 0; i < N; i++)
+        src.push_back(make_value<T>(i));
+
+    stack_vector::stack_vector<T, N> vec;
+    fill_to(vec, src, N);
+    runner.run("churn", "stack_vector", element_name, N, N, [&] {
+        for (size_t i = 0; i < N; i++) {
+            vec.erase(vec.begin() + (i * 7) % N);
+            vec.push_back(src[i]);
+        }
+        bench::do_not_optimize(vec);
+    });
+
+    using slot_map_type = stack_vector::stack_slot_map<T, N>;
+    slot_map_type                               slots;
+    std::vector<typename slot_map_type::handle> handles;
+    for (size_t i = 0; i < N; i++)
+        handles.push_back(slots.insert(src[i]));
+    runner.run("churn", "stack_slot_map", element_name, N, N, [&] {
+        for (size_t i = 0; i < N; i++) {
+            auto &h = handles[(i * 7) % N];
+            slots.erase(h);
+            h = slots.insert(src[i]);
+        }
+        bench::do_not_optimize(slots);
+    });
+}
+
+// drops every fourth element and refills, one erase per element against one erase_indices pass
+template <typename T, size_t N> void run_bulk_erase(bench::runner &runner, const char *element_name) {
+    std::vector<T> src;
+    for (size_t i = 0; i < N; i++)
+        src.push_back(make_value<T>(i));
+    std::vector<size_t> expired;
+    for (size_t i = 0; i < N; i += 4)
+        expired.push_back(i);
+
+    stack_vector::stack_vector<T, N> vec;
+    runner.run("drop_expired", "erase_each", element_name, N, expired.size(), [&] {
+        fill_to(vec, src, N);
+        for (size_t k = expired.size(); k-- > 0;)
+            vec.erase(vec.begin() + expired[k]);
+        bench::do_not_optimize(vec);
+    });
+    runner.run("drop_expired", "erase_indices", element_name, N, expired.size(), [&] {
+        fill_to(vec, src, N);
+        vec.erase_indices(expired);
+        bench::do_not_optimize(vec);
+    });
+}
+
+// sorting a shuffled container, and picking the top 8 of it, against the std algorithms. The input cycles
+// through a few shuffles so the branch predictor can't learn one of them.
+template <typename T, size_t N> void run_sort(bench::runner &runner, const char *element_name) {
+    constexpr size_t            shuffles = N < 256 ? 4096 / N : 16;
+    std::vector<std::vector<T>> src(shuffles);
+    std::mt19937                rng(42);
+    for (auto &shuffle : src) {
+        for (size_t i = 0; i < N; i++)
+            shuffle.push_back(make_value<T>(i));
+        std::shuffle(shuffle.begin(), shuffle.end(), rng);
+    }
+    constexpr size_t top  = N < 8 ? N : 8;
+    size_t           next = 0;
+
+    stack_vector::stack_vector<T, N> vec;
+    auto                             refill = [&] {
+        vec.assign(src[next].begin(), src[next].end());
+        next = (next + 1) % shuffles;
+    };
+    runner.run("sort", "std::sort", element_name, N, N, [&] {
+        refill();
+        std::sort(vec.begin(), vec.end());
+        bench::do_not_optimize(vec);
+    });
+    runner.run("sort", "stack_vector", element_name, N, N, [&] {
+        refill();
+        vec.sort();
+        bench::do_not_optimize(vec);
+    });
+    runner.run("top_8", "std::partial_sort", element_name, N, N, [&] {
+        refill();
+        std::partial_sort(vec.begin(), vec.begin() + top, vec.end());
+        bench::do_not_optimize(vec);
+    });
+    runner.run("top_8", "stack_vector", element_name, N, N, [&] {
+        refill();
+        vec.partial_sort(vec.begin() + top);
+        bench::do_not_optimize(vec);
+    });
+}
+
+template <typename T, size_t N> void run_capacity(bench::runner &runner, const char *element_name) {
+    run_container<stack_vector::stack_vector<T, N>, T, N>(runner, element_name);
+    run_container<std::vector<T>, T, N>(runner, element_name);
+    run_container<array_vector<T, N>, T, N>(runner, element_name);
+    run_fifo<T, N>(runner, element_name);
+    run_churn<T, N>(runner, element_name);
+    run_bulk_erase<T, N>(runner, element_name);
+    run_sort<T, N>(runner, element_name);
+#if STACK_VECTOR_BENCH_BOOST
+    run_container<boost::container::static_vector<T, N>, T, N>(runner, element_name);
+#endif
+}
+
+template <typename T> void run_element(bench::runner &runner, const char *element_name) {
+    run_capacity<T, 16>(runner, element_name);
+    run_capacity<T, 128>(runner, element_name);
+    run_capacity<T, 1024>(runner, element_name);
+}
+
+int main(int argc, char **argv) {
+    bench::runner runner(bench::options::parse(argc, argv));
+    run_element<int>(runner, "int");
+    run_element<pod64>(runner, "pod64");
+    run_element<std::string>(runner, "std_string");
+    return 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2022 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// tunables, per block size
+#ifndef BLOCK_POOL_THREAD_CACHE_SIZE
+#define BLOCK_POOL_THREAD_CACHE_SIZE 64
+#endif
+#ifndef BLOCK_POOL_BATCH_SIZE
+#define BLOCK_POOL_BATCH_SIZE 16
+#endif
+#ifndef BLOCK_POOL_SHARED_CAPACITY
+#define BLOCK_POOL_SHARED_CAPACITY 4096
+#endif
+
+namespace rope {
+    // fixed size blocks recycled through a small per thread free list, refilled from and flushed to a
+    // shared free list a batch at a time, anything past the shared capacity goes back to the system
+    template <size_t BlockSize, size_t BlockAlign> class block_pool {
+        static_assert(BLOCK_POOL_BATCH_SIZE <= BLOCK_POOL_THREAD_CACHE_SIZE,
+                      "a block_pool batch must fit in the thread cache");
+
+      public:
+        static constexpr size_t block_size      = BlockSize;
+        static constexpr size_t block_align     = BlockAlign;
+        static constexpr size_t cache_capacity  = BLOCK_POOL_THREAD_CACHE_SIZE;
+        static constexpr size_t batch_size      = BLOCK_POOL_BATCH_SIZE;
+        static constexpr size_t shared_capacity = BLOCK_POOL_SHARED_CAPACITY;
+
+        struct statistics {
+            uint64_t hits;          // served from a thread cache
+            uint64_t refills;       // thread cache refilled from the shared list
+            uint64_t flushes;       // thread cache spilled into the shared list
+            uint64_t misses;        // allocated from the system
+            uint64_t system_frees;  // returned to the system
+            size_t   shared_blocks; // blocks currently in the shared list
+        };
+
+      private:
+        struct thread_cache {
+            ::stack_vector::stack_vector<void *, cache_capacity> blocks;
+            // folded into the shared counters on refill, flush and thread exit
+            uint64_t hits = 0;
+
+            ~thread_cache() {
+                block_pool &pool = instance();
+                pool.return_blocks(blocks.data(), blocks.size());
+                pool._hits.fetch_add(hits, ::std::memory_order_relaxed);
+                blocks.clear();
+                cache_alive() = false;
+            }
+        };
+
+        ::std::mutex         _mutex;
+        ::std::vector<void *> _shared;
+        ::std::atomic<uint64_t> _hits{0};
+        ::std::atomic<uint64_t> _refills{0};
+        ::std::atomic<uint64_t> _flushes{0};
+        ::std::atomic<uint64_t> _misses{0};
+        ::std::atomic<uint64_t> _system_frees{0};
+
+        block_pool() {
+            _shared.reserve(shared_capacity);
+        }
+
+        // trivially destructible, so it can still be read after the thread's cache is gone
+        static bool &cache_alive() noexcept {
+            thread_local bool alive = true;
+            return alive;
+        }
+        // nullptr once the thread's cache has been destroyed, blocks freed after that (by a static
+        // block_rope, say) go straight to the shared list
+        static thread_cache *local_cache() {
+            if (!cache_alive()) [[unlikely]]
+                return nullptr;
+            thread_local thread_cache cache;
+            return &cache;
+        }
+        static void *system_allocate() {
+            return ::operator new(block_size, ::std::align_val_t(block_align));
+        }
+        static void system_free(void *block) noexcept {
+            ::operator delete(block, block_size, ::std::align_val_t(block_align));
+        }
+
+        // moves up to count shared blocks into dest, returns how many
+        size_t take_blocks(void **dest, size_t count) {
+            ::std::lock_guard<::std::mutex> lock(_mutex);
+            const size_t taken = ::std::min(count, _shared.size());
+            ::std::copy(_shared.end() - taken, _shared.end(), dest);
+            _shared.resize(_shared.size() - taken);
+            return taken;
+        }
+        void return_blocks(void *const *blocks, size_t count) noexcept {
+            size_t kept = 0;
+            {
+                ::std::lock_guard<::std::mutex> lock(_mutex);
+                kept = ::std::min(count, shared_capacity - ::std::min(shared_capacity, _shared.size()));
+                _shared.insert(_shared.end(), blocks, blocks + kept);
+            }
+            for (size_t i = kept; i < count; i++)
+                system_free(blocks[i]);
+            if (count > kept)
+                _system_frees.fetch_add(count - kept, ::std::memory_order_relaxed);
+        }
+
+      public:
+        block_pool(const block_pool &)            = delete;
+        block_pool &operator=(const block_pool &) = delete;
+
+        // never destroyed, so the blocks of ropes torn down after the other statics (a global block_rope)
+        // and of threads exiting late still have a pool to go back to. Its shared blocks are left to the
+        // system at exit.
+        static block_pool &instance() {
+            static block_pool *pool = new block_pool();
+            return *pool;
+        }
+
+        void *allocate() {
+            thread_cache *cache = local_cache();
+            if (!cache) [[unlikely]] {
+                void *block = nullptr;
+                if (take_blocks(&block, 1))
+                    return block;
+                _misses.fetch_add(1, ::std::memory_order_relaxed);
+                return system_allocate();
+            }
+            if (cache->blocks.empty()) [[unlikely]] {
+                cache->blocks.resize_and_overwrite(batch_size, [this](void **dest, size_t count) {
+                    return take_blocks(dest, count);
+                });
+                if (cache->blocks.empty()) {
+                    _misses.fetch_add(1, ::std::memory_order_relaxed);
+                    return system_allocate();
+                }
+                _refills.fetch_add(1, ::std::memory_order_relaxed);
+                _hits.fetch_add(cache->hits, ::std::memory_order_relaxed);
+                cache->hits = 0;
+            }
+            cache->hits += 1;
+            void *block = cache->blocks.back();
+            cache->blocks.pop_back();
+            return block;
+        }
+
+        void deallocate(void *block) noexcept {
+            thread_cache *cache = local_cache();
+            if (!cache) [[unlikely]] {
+                return_blocks(&block, 1);
+                return;
+            }
+            if (cache->blocks.full()) [[unlikely]] {
+                // spill the oldest batch, the most recently freed (cache warm) blocks stay local
+                return_blocks(cache->blocks.data(), batch_size);
+                cache->blocks.erase(cache->blocks.begin(), cache->blocks.begin() + batch_size);
+                _flushes.fetch_add(1, ::std::memory_order_relaxed);
+                _hits.fetch_add(cache->hits, ::std::memory_order_relaxed);
+                cache->hits = 0;
+            }
+            cache->blocks.shove_back(block);
+        }
+
+        // counts from other threads are folded in at their next refill, flush or exit
+        statistics stats() {
+            thread_cache *cache = local_cache();
+            statistics    ret;
+            ret.hits         = _hits.load(::std::memory_order_relaxed) + (cache ? cache->hits : 0);
+            ret.refills      = _refills.load(::std::memory_order_relaxed);
+            ret.flushes      = _flushes.load(::std::memory_order_relaxed);
+            ret.misses       = _misses.load(::std::memory_order_relaxed);
+            ret.system_frees = _system_frees.load(::std::memory_order_relaxed);
+            {
+                ::std::lock_guard<::std::mutex> lock(_mutex);
+                ret.shared_blocks = _shared.size();
+            }
+            return ret;
+        }
+
+        // returns the shared blocks to the system, the shared list keeps its reserved capacity so nothing
+        // here allocates
+        void trim() noexcept {
+            ::std::lock_guard<::std::mutex> lock(_mutex);
+            for (void *block : _shared)
+                system_free(block);
+            _system_frees.fetch_add(_shared.size(), ::std::memory_order_relaxed);
+            _shared.clear();
+        }
+    };
+
+    template <typename T>
+    using block_pool_for = ::rope::block_pool<sizeof(T), alignof(T)>;
+} // namespace rope
@@ -0,0 +1,197 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // up to N T's appended from any number of threads at once. Producers claim slots with one fetch_add
+    // (a single slot or a whole batch), construct in place, then count themselves done. seal() stops
+    // further appends and waits for the ones in flight, after that it reads like a stack_vector.
+    template <typename T, size_t N> struct concurrent_stack_vector {
+        static_assert(N > 0, "a concurrent_stack_vector<T,N> must have an N > 0");
+
+      public:
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using const_reference = const value_type &;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer         = element_type *;
+        using const_pointer   = const element_type *;
+        using reference       = element_type &;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+
+      private:
+        // claimed slots, may run past N once producers start overflowing
+        alignas(STACK_VECTOR_CACHE_LINE_SIZE)::std::atomic<size_type> _reserved = 0;
+        // constructed slots, on its own line so finishing producers don't slow claiming ones
+        alignas(STACK_VECTOR_CACHE_LINE_SIZE)::std::atomic<size_type> _completed = 0;
+        size_type _size   = 0;
+        bool      _sealed = false;
+        ::stack_vector::details::inline_buffer<T, N> _elements;
+
+        // how many of count slots claimed at start are inside the storage
+        static constexpr size_type room_at(size_type start, size_type count) noexcept {
+            return start < N ? ::std::min(count, N - start) : 0;
+        }
+        // claimed slots can't be handed back, so running out follows stack_vector's error handling only
+        // after the part that fits is in
+        static bool overflow() {
+            ::stack_vector::details::report_full(
+                "concurrent_stack_vector cannot allocate to append elements");
+            return false;
+        }
+        // a claimed slot left empty would keep seal() waiting forever, so a throwing constructor terminates
+        template <class... Args> static void construct(T *slot, Args &&...args) noexcept {
+            ::new ((void *)slot) T(::std::forward<Args>(args)...);
+        }
+        [[nodiscard]] size_type constructed() const noexcept {
+            return _sealed ? _size : ::std::min(_reserved.load(::std::memory_order_acquire), N);
+        }
+
+      public:
+        constexpr concurrent_stack_vector() noexcept {
+        }
+        concurrent_stack_vector(const concurrent_stack_vector &)            = delete;
+        concurrent_stack_vector &operator=(const concurrent_stack_vector &) = delete;
+        ~concurrent_stack_vector() {
+            clear();
+        }
+
+        // producers, any thread. false when there was no room (after throwing if the error handling says so)
+        template <class... Args> bool emplace_back(Args &&...args) {
+            const size_type index = _reserved.fetch_add(1, ::std::memory_order_relaxed);
+            if (index >= N) [[unlikely]]
+                return overflow();
+            construct(_elements.store.data() + index, ::std::forward<Args>(args)...);
+            _completed.fetch_add(1, ::std::memory_order_release);
+            return true;
+        }
+        bool shove_back(const T &value) {
+            return emplace_back(value);
+        }
+        bool shove_back(T &&value) {
+            return emplace_back(::std::move(value));
+        }
+        // claims room for the whole range with one fetch_add and copies it in, returns how many went in (a
+        // range straddling the end keeps the part that fits). An iterator that may throw could leave claimed
+        // slots empty, so those ranges go in one emplace_back at a time, each element read before its claim.
+        template <::std::forward_iterator It1> size_type append(It1 first, It1 last) {
+            if constexpr (!noexcept(*::std::declval<It1 &>()) || !noexcept(++::std::declval<It1 &>())) {
+                size_type appended = 0;
+                for (; first != last; ++first, ++appended) {
+                    if (!emplace_back(*first))
+                        break;
+                }
+                return appended;
+            }
+            const size_type count = size_type(::std::distance(first, last));
+            if (!count)
+                return 0;
+            const size_type start = _reserved.fetch_add(count, ::std::memory_order_relaxed);
+            const size_type room  = room_at(start, count);
+            for (size_type i = 0; i < room; ++i, ++first)
+                construct(_elements.store.data() + start + i, *first);
+            if (room)
+                _completed.fetch_add(room, ::std::memory_order_release);
+            if (room < count) [[unlikely]]
+                overflow();
+            return room;
+        }
+        size_type append(::std::span<const T> values) {
+            return append(values.begin(), values.end());
+        }
+
+        // stops further appends (they fail as if full) and waits for the ones in flight, the reading
+        // functions below are only valid after it
+        ::std::span<T> seal() noexcept {
+            if (!_sealed) {
+                // any claim after the exchange starts at N or later
+                _size = ::std::min(_reserved.exchange(N, ::std::memory_order_acq_rel), N);
+                while (_completed.load(::std::memory_order_acquire) != _size)
+                    ::std::this_thread::yield();
+                _sealed = true;
+            }
+            return ::std::span<T>(data(), _size);
+        }
+        [[nodiscard]] bool sealed() const noexcept {
+            return _sealed;
+        }
+        // how many appends have finished, a snapshot while producers run
+        [[nodiscard]] size_type size_approx() const noexcept {
+            return _completed.load(::std::memory_order_acquire);
+        }
+        // reopens for appends, not thread safe
+        void clear() noexcept {
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::stack_vector::details::destroy(data(), data() + constructed());
+            _reserved.store(0, ::std::memory_order_relaxed);
+            _completed.store(0, ::std::memory_order_relaxed);
+            _size   = 0;
+            _sealed = false;
+        }
+
+        // readers, after seal()
+        [[nodiscard]] size_type size() const noexcept {
+            assert(_sealed && "concurrent_stack_vector must be sealed before reading");
+            return _size;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return !size();
+        }
+        [[nodiscard]] static constexpr size_type capacity() noexcept {
+            return N;
+        }
+        [[nodiscard]] pointer data() noexcept {
+            return _elements.store.data();
+        }
+        [[nodiscard]] const_pointer data() const noexcept {
+            return _elements.store.data();
+        }
+        [[nodiscard]] reference operator[](size_type pos) noexcept {
+            assert(pos < size());
+            return data()[pos];
+        }
+        [[nodiscard]] const_reference operator[](size_type pos) const noexcept {
+            assert(pos < size());
+            return data()[pos];
+        }
+        [[nodiscard]] iterator begin() noexcept {
+            return data();
+        }
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return data();
+        }
+        [[nodiscard]] iterator end() noexcept {
+            return data() + size();
+        }
+        [[nodiscard]] const_iterator end() const noexcept {
+            return data() + size();
+        }
+    };
+} // namespace stack_vector
@@ -0,0 +1,724 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// up to this many arithmetic keys a lookup counts the smaller keys with the vector kernels instead of
+// halving the range
+#ifndef STACK_VECTOR_FLAT_LINEAR_MAX
+#define STACK_VECTOR_FLAT_LINEAR_MAX 32
+#endif
+
+namespace stack_vector {
+    namespace details {
+        template <typename Compare>
+        concept transparent_compare = requires { typename Compare::is_transparent; };
+
+        template <typename K, typename Compare, typename Key>
+        constexpr bool flat_linear_search =
+            ::stack_vector::simd::kernel_type<K> && ::std::is_same<K, Key>::value &&
+            (::std::is_same<Compare, ::std::less<K>>::value || ::std::is_same<Compare, ::std::less<>>::value);
+
+        // the index of the first key not ordered before key
+        template <typename K, typename Key, typename Compare>
+        constexpr size_t flat_lower_bound(const K *keys, size_t count, const Key &key, const Compare &comp) {
+            if constexpr (flat_linear_search<K, Compare, Key>) {
+                if (count <= STACK_VECTOR_FLAT_LINEAR_MAX)
+                    return ::stack_vector::simd::count_less(keys, count, key);
+            }
+            if (!count)
+                return 0;
+            // the compare only picks the next base (a cmov), it never decides a jump
+            const K *base = keys;
+            while (count > 1) {
+                const size_t half = count / 2;
+                base              = comp(base[half], key) ? base + half : base;
+                count -= half;
+            }
+            return size_t(base - keys) + size_t(comp(*base, key));
+        }
+
+        // stands in for the values of a set
+        struct flat_no_values {};
+
+        // sorts keys (and values alongside) through an index permutation, the first of equal keys is kept
+        template <typename K, size_t N, size_layout L, typename Compare, typename Values>
+        constexpr void flat_sort_unique(::stack_vector::stack_vector<K, N, L> &keys, Values *values,
+                                        const Compare &comp) {
+            using index_type = ::stack_vector::details::smallest_size_t<N>;
+            ::stack_vector::stack_vector<index_type, N> order;
+            for (size_t i = 0; i < keys.size(); i++)
+                order.shove_back(index_type(i));
+            // ties go to the earlier index so the (unstable, non allocating) sort acts stable
+            order.sort([&](index_type left, index_type right) {
+                if (comp(keys[left], keys[right]))
+                    return true;
+                return !comp(keys[right], keys[left]) && left < right;
+            });
+            ::stack_vector::stack_vector<K, N, L> sorted_keys;
+            Values                                sorted_values;
+            for (index_type at : order) {
+                if (!sorted_keys.empty() && !comp(sorted_keys.back(), keys[at]))
+                    continue;
+                sorted_keys.unchecked_emplace_back(::std::move(keys[at]));
+                if constexpr (!::std::is_same<Values, flat_no_values>::value)
+                    sorted_values.unchecked_emplace_back(::std::move((*values)[at]));
+            }
+            keys = ::std::move(sorted_keys);
+            if constexpr (!::std::is_same<Values, flat_no_values>::value)
+                *values = ::std::move(sorted_values);
+        }
+
+        template <typename RetType> constexpr RetType flat_full(RetType ret) {
+            ::stack_vector::details::report_full("stack_flat container cannot allocate to insert elements");
+            return ret;
+        }
+    } // namespace details
+
+    // up to N sorted keys in one stack_vector, their values at the same index in another
+    template <typename K, typename V, size_t N, typename Compare = ::std::less<K>> struct stack_flat_map {
+      public:
+        using key_type        = K;
+        using mapped_type     = V;
+        using value_type      = ::std::pair<K, V>;
+        using key_compare     = Compare;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using reference       = ::std::pair<const K &, V &>;
+        using const_reference = ::std::pair<const K &, const V &>;
+
+        // walks both arrays at once, dereferences to a pair of references
+        template <bool Const> class basic_iterator {
+            friend struct stack_flat_map;
+            friend class basic_iterator<!Const>;
+            using value_pointer = typename ::std::conditional<Const, const V *, V *>::type;
+
+            const K      *_key   = nullptr;
+            value_pointer _value = nullptr;
+
+            constexpr basic_iterator(const K *key, value_pointer value) noexcept : _key(key), _value(value) {
+            }
+
+          public:
+            // reference is a pair of references made on the fly, so for the legacy algorithms this is only
+            // an input iterator
+            using iterator_concept  = ::std::random_access_iterator_tag;
+            using iterator_category = ::std::input_iterator_tag;
+            using value_type        = ::std::pair<K, V>;
+            using difference_type   = ::std::ptrdiff_t;
+            using reference = ::std::pair<const K &, typename ::std::conditional<Const, const V &, V &>::type>;
+            struct pointer {
+                reference ref;
+                constexpr const reference *operator->() const noexcept {
+                    return &ref;
+                }
+            };
+
+            constexpr basic_iterator() noexcept = default;
+            template <bool OtherConst>
+            constexpr basic_iterator(const basic_iterator<OtherConst> &other) noexcept requires(Const && !OtherConst)
+                : _key(other._key), _value(other._value) {
+            }
+
+            constexpr reference operator*() const noexcept {
+                return reference(*_key, *_value);
+            }
+            constexpr pointer operator->() const noexcept {
+                return pointer{**this};
+            }
+            constexpr reference operator[](difference_type n) const noexcept {
+                return *(*this + n);
+            }
+            constexpr const K &key() const noexcept {
+                return *_key;
+            }
+            constexpr auto &value() const noexcept {
+                return *_value;
+            }
+
+            constexpr basic_iterator &operator++() noexcept {
+                ++_key;
+                ++_value;
+                return *this;
+            }
+            constexpr basic_iterator operator++(int) noexcept {
+                basic_iterator ret = *this;
+                ++*this;
+                return ret;
+            }
+            constexpr basic_iterator &operator--() noexcept {
+                --_key;
+                --_value;
+                return *this;
+            }
+            constexpr basic_iterator operator--(int) noexcept {
+                basic_iterator ret = *this;
+                --*this;
+                return ret;
+            }
+            constexpr basic_iterator &operator+=(difference_type n) noexcept {
+                _key += n;
+                _value += n;
+                return *this;
+            }
+            constexpr basic_iterator &operator-=(difference_type n) noexcept {
+                return *this += -n;
+            }
+            friend constexpr basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+                return it -= n;
+            }
+            friend constexpr difference_type operator-(const basic_iterator &left,
+                                                       const basic_iterator &right) noexcept {
+                return left._key - right._key;
+            }
+            friend constexpr bool operator==(const basic_iterator &left, const basic_iterator &right) noexcept {
+                return left._key == right._key;
+            }
+            friend constexpr auto operator<=>(const basic_iterator &left, const basic_iterator &right) noexcept {
+                return left._key <=> right._key;
+            }
+        };
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+      private:
+        ::stack_vector::stack_vector<K, N> _keys;
+        ::stack_vector::stack_vector<V, N> _values;
+        [[no_unique_address]] Compare      _comp;
+
+        constexpr iterator make_iterator(size_type index) noexcept {
+            return iterator(_keys.data() + index, _values.data() + index);
+        }
+        constexpr const_iterator make_iterator(size_type index) const noexcept {
+            return const_iterator(_keys.data() + index, _values.data() + index);
+        }
+        template <typename Key> constexpr size_type lower_index(const Key &key) const {
+            return ::stack_vector::details::flat_lower_bound(_keys.data(), _keys.size(), key, _comp);
+        }
+        template <typename Key> constexpr size_type find_index(const Key &key) const {
+            const size_type index = lower_index(key);
+            return (index < size() && !_comp(key, _keys[index])) ? index : size();
+        }
+        template <typename Key> constexpr size_type upper_index(const Key &key) const {
+            const size_type index = lower_index(key);
+            return index + size_type(index < size() && !_comp(key, _keys[index]));
+        }
+        // whether key is among the first count keys, which are sorted
+        constexpr bool sorted_contains(size_type count, const K &key) const {
+            const size_type index = ::stack_vector::details::flat_lower_bound(_keys.data(), count, key, _comp);
+            return index < count && !_comp(key, _keys[index]);
+        }
+        template <typename KeyArg, class... Args>
+        constexpr ::std::pair<iterator, bool> try_emplace_impl(KeyArg &&key, Args &&...args) {
+            const size_type index = lower_index(key);
+            if (index < size() && !_comp(key, _keys[index]))
+                return {make_iterator(index), false};
+            if (full())
+                return {::stack_vector::details::flat_full(end()), false};
+            _keys.emplace(_keys.begin() + index, ::std::forward<KeyArg>(key));
+            if constexpr (::std::is_nothrow_constructible<V, Args &&...>::value) {
+                _values.emplace(_values.begin() + index, ::std::forward<Args>(args)...);
+            } else {
+                try {
+                    _values.emplace(_values.begin() + index, ::std::forward<Args>(args)...);
+                } catch (...) {
+                    _keys.erase(_keys.begin() + index);
+                    throw;
+                }
+            }
+            return {make_iterator(index), true};
+        }
+
+        // not constexpr, a full map can't be written through operator[] in a constant expression
+        static V &overflow_value() {
+            static thread_local V sink;
+            sink = V();
+            return sink;
+        }
+
+      public:
+        // constructor's
+        constexpr stack_flat_map() noexcept = default;
+        explicit constexpr stack_flat_map(const Compare &comp) : _comp(comp) {
+        }
+        // bulk construction, sorted once and deduplicated (the first of equal keys wins)
+        template <::std::input_iterator It1>
+        constexpr stack_flat_map(It1 first, It1 last, const Compare &comp = Compare()) : _comp(comp) {
+            insert(first, last);
+        }
+        constexpr stack_flat_map(::std::initializer_list<value_type> init, const Compare &comp = Compare())
+            : _comp(comp) {
+            insert(init.begin(), init.end());
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _keys.empty();
+        }
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _keys.full();
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _keys.size();
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return N;
+        }
+
+        // the sorted keys and their values, index for index
+        [[nodiscard]] constexpr ::std::span<const K> keys() const noexcept {
+            return ::std::span<const K>(_keys.data(), _keys.size());
+        }
+        [[nodiscard]] constexpr ::std::span<V> values() noexcept {
+            return ::std::span<V>(_values.data(), _values.size());
+        }
+        [[nodiscard]] constexpr ::std::span<const V> values() const noexcept {
+            return ::std::span<const V>(_values.data(), _values.size());
+        }
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return _comp;
+        }
+
+        // iterators
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return make_iterator(0);
+        }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return make_iterator(0);
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return make_iterator(0);
+        }
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return make_iterator(size());
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return make_iterator(size());
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return make_iterator(size());
+        }
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        // lookups, and through a transparent compare the same for anything it takes
+        [[nodiscard]] constexpr iterator find(const K &key) {
+            return make_iterator(find_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator find(const K &key) const {
+            return make_iterator(find_index(key));
+        }
+        [[nodiscard]] constexpr bool contains(const K &key) const {
+            return find_index(key) != size();
+        }
+        [[nodiscard]] constexpr size_type count(const K &key) const {
+            return size_type(find_index(key) != size());
+        }
+        [[nodiscard]] constexpr iterator lower_bound(const K &key) {
+            return make_iterator(lower_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator lower_bound(const K &key) const {
+            return make_iterator(lower_index(key));
+        }
+        [[nodiscard]] constexpr iterator upper_bound(const K &key) {
+            return make_iterator(upper_index(key));
+        }
+        [[nodiscard]] constexpr const_iterator upper_bound(const K &key) const {
+            return make_iterator(upper_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator find(const Key &key) {
+            return make_iterator(find_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator find(const Key &key) const {
+            return make_iterator(find_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr bool contains(const Key &key) const {
+            return find_index(key) != size();
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr size_type count(const Key &key) const {
+            return size_type(find_index(key) != size());
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator lower_bound(const Key &key) {
+            return make_iterator(lower_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator lower_bound(const Key &key) const {
+            return make_iterator(lower_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr iterator upper_bound(const Key &key) {
+            return make_iterator(upper_index(key));
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator upper_bound(const Key &key) const {
+            return make_iterator(upper_index(key));
+        }
+
+        // element access
+        [[nodiscard]] constexpr V &at(const K &key) {
+            const size_type index = find_index(key);
+            if (index == size())
+                throw ::std::out_of_range("stack_flat_map has no such key");
+            return _values[index];
+        }
+        [[nodiscard]] constexpr const V &at(const K &key) const {
+            const size_type index = find_index(key);
+            if (index == size())
+                throw ::std::out_of_range("stack_flat_map has no such key");
+            return _values[index];
+        }
+        // a new key on a full map follows stack_vector's error handling, when that doesn't throw the
+        // reference is to a default V off to the side and whatever is written to it is dropped
+        constexpr V &operator[](const K &key) {
+            auto ret = try_emplace_impl(key);
+            if (ret.first == end()) [[unlikely]]
+                return overflow_value();
+            return ret.first.value();
+        }
+        constexpr V &operator[](K &&key) {
+            auto ret = try_emplace_impl(::std::move(key));
+            if (ret.first == end()) [[unlikely]]
+                return overflow_value();
+            return ret.first.value();
+        }
+
+        // modifiers, a full map follows stack_vector's error handling and hands back {end(), false}
+        template <class... Args> constexpr ::std::pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+            return try_emplace_impl(key, ::std::forward<Args>(args)...);
+        }
+        template <class... Args> constexpr ::std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+            return try_emplace_impl(::std::move(key), ::std::forward<Args>(args)...);
+        }
+        template <class... Args> constexpr ::std::pair<iterator, bool> emplace(Args &&...args) {
+            value_type value(::std::forward<Args>(args)...);
+            return try_emplace_impl(::std::move(value.first), ::std::move(value.second));
+        }
+        constexpr ::std::pair<iterator, bool> insert(const value_type &value) {
+            return try_emplace_impl(value.first, value.second);
+        }
+        constexpr ::std::pair<iterator, bool> insert(value_type &&value) {
+            return try_emplace_impl(::std::move(value.first), ::std::move(value.second));
+        }
+        template <class M> constexpr ::std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj) {
+            auto ret = try_emplace_impl(key, ::std::forward<M>(obj));
+            if (!ret.second && ret.first != end())
+                ret.first.value() = ::std::forward<M>(obj);
+            return ret;
+        }
+        // appends then sorts once, keys already in the map win over new ones and are skipped before the
+        // capacity is checked. Repeats among the new keys only count against it until the map fills up, then
+        // they're squeezed out by an early sort.
+        template <::std::input_iterator It1> constexpr void insert(It1 first, It1 last) {
+            size_type sorted = size();
+            for (; first != last; ++first) {
+                const auto &value = *first;
+                if (sorted_contains(sorted, value.first))
+                    continue;
+                if (full()) {
+                    ::stack_vector::details::flat_sort_unique(_keys, &_values, _comp);
+                    sorted = size();
+                    if (sorted_contains(sorted, value.first))
+                        continue;
+                    if (full()) {
+                        ::stack_vector::details::flat_full(0);
+                        return;
+                    }
+                }
+                _keys.unchecked_emplace_back(value.first);
+                _values.unchecked_emplace_back(value.second);
+            }
+            ::stack_vector::details::flat_sort_unique(_keys, &_values, _comp);
+        }
+        constexpr void insert(::std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        constexpr iterator erase(const_iterator pos) {
+            const size_type index = size_type(pos._key - _keys.data());
+            _keys.erase(_keys.begin() + index);
+            _values.erase(_values.begin() + index);
+            return make_iterator(index);
+        }
+        constexpr size_type erase(const K &key) {
+            const size_type index = find_index(key);
+            if (index == size())
+                return 0;
+            erase(make_iterator(index));
+            return 1;
+        }
+        constexpr void clear() noexcept {
+            _keys.clear();
+            _values.clear();
+        }
+        constexpr void swap(stack_flat_map &other) noexcept {
+            _keys.swap(other._keys);
+            _values.swap(other._values);
+            ::std::swap(_comp, other._comp);
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const stack_flat_map &left, const stack_flat_map &right) {
+            return left._keys == right._keys && left._values == right._values;
+        }
+    };
+
+    // up to N sorted keys in a stack_vector
+    template <typename K, size_t N, typename Compare = ::std::less<K>> struct stack_flat_set {
+      public:
+        using key_type               = K;
+        using value_type             = K;
+        using key_compare            = Compare;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using reference              = const K &;
+        using const_reference        = const K &;
+        using iterator               = const K *;
+        using const_iterator         = const K *;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+      private:
+        ::stack_vector::stack_vector<K, N> _keys;
+        [[no_unique_address]] Compare      _comp;
+
+        template <typename Key> constexpr size_type lower_index(const Key &key) const {
+            return ::stack_vector::details::flat_lower_bound(_keys.data(), _keys.size(), key, _comp);
+        }
+        template <typename Key> constexpr size_type find_index(const Key &key) const {
+            const size_type index = lower_index(key);
+            return (index < size() && !_comp(key, _keys[index])) ? index : size();
+        }
+        template <typename Key> constexpr size_type upper_index(const Key &key) const {
+            const size_type index = lower_index(key);
+            return index + size_type(index < size() && !_comp(key, _keys[index]));
+        }
+        // whether key is among the first count keys, which are sorted
+        constexpr bool sorted_contains(size_type count, const K &key) const {
+            const size_type index = ::stack_vector::details::flat_lower_bound(_keys.data(), count, key, _comp);
+            return index < count && !_comp(key, _keys[index]);
+        }
+        template <typename KeyArg> constexpr ::std::pair<iterator, bool> insert_impl(KeyArg &&key) {
+            const size_type index = lower_index(key);
+            if (index < size() && !_comp(key, _keys[index]))
+                return {begin() + index, false};
+            if (full())
+                return {::stack_vector::details::flat_full(end()), false};
+            _keys.emplace(_keys.begin() + index, ::std::forward<KeyArg>(key));
+            return {begin() + index, true};
+        }
+
+      public:
+        // constructor's
+        constexpr stack_flat_set() noexcept = default;
+        explicit constexpr stack_flat_set(const Compare &comp) : _comp(comp) {
+        }
+        // bulk construction, sorted once and deduplicated
+        template <::std::input_iterator It1>
+        constexpr stack_flat_set(It1 first, It1 last, const Compare &comp = Compare()) : _comp(comp) {
+            insert(first, last);
+        }
+        constexpr stack_flat_set(::std::initializer_list<K> init, const Compare &comp = Compare()) : _comp(comp) {
+            insert(init.begin(), init.end());
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _keys.empty();
+        }
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _keys.full();
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _keys.size();
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr key_compare key_comp() const {
+            return _comp;
+        }
+
+        // iterators
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _keys.data();
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return _keys.data();
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return _keys.data() + _keys.size();
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return end();
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        // lookups, and through a transparent compare the same for anything it takes
+        [[nodiscard]] constexpr const_iterator find(const K &key) const {
+            return begin() + find_index(key);
+        }
+        [[nodiscard]] constexpr bool contains(const K &key) const {
+            return find_index(key) != size();
+        }
+        [[nodiscard]] constexpr size_type count(const K &key) const {
+            return size_type(find_index(key) != size());
+        }
+        [[nodiscard]] constexpr const_iterator lower_bound(const K &key) const {
+            return begin() + lower_index(key);
+        }
+        [[nodiscard]] constexpr const_iterator upper_bound(const K &key) const {
+            return begin() + upper_index(key);
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator find(const Key &key) const {
+            return begin() + find_index(key);
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr bool contains(const Key &key) const {
+            return find_index(key) != size();
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr size_type count(const Key &key) const {
+            return size_type(find_index(key) != size());
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator lower_bound(const Key &key) const {
+            return begin() + lower_index(key);
+        }
+        template <typename Key>
+        requires ::stack_vector::details::transparent_compare<Compare>
+        [[nodiscard]] constexpr const_iterator upper_bound(const Key &key) const {
+            return begin() + upper_index(key);
+        }
+
+        // modifiers, a full set follows stack_vector's error handling and hands back {end(), false}
+        constexpr ::std::pair<iterator, bool> insert(const K &key) {
+            return insert_impl(key);
+        }
+        constexpr ::std::pair<iterator, bool> insert(K &&key) {
+            return insert_impl(::std::move(key));
+        }
+        template <class... Args> constexpr ::std::pair<iterator, bool> emplace(Args &&...args) {
+            return insert_impl(K(::std::forward<Args>(args)...));
+        }
+        // appends then sorts once, keys already in the set are skipped before the capacity is checked and
+        // repeats among the new ones are squeezed out by an early sort when it fills up
+        template <::std::input_iterator It1> constexpr void insert(It1 first, It1 last) {
+            ::stack_vector::details::flat_no_values no_values;
+            size_type                               sorted = size();
+            for (; first != last; ++first) {
+                const auto &key = *first;
+                if (sorted_contains(sorted, key))
+                    continue;
+                if (full()) {
+                    ::stack_vector::details::flat_sort_unique(_keys, &no_values, _comp);
+                    sorted = size();
+                    if (sorted_contains(sorted, key))
+                        continue;
+                    if (full()) {
+                        ::stack_vector::details::flat_full(0);
+                        return;
+                    }
+                }
+                _keys.unchecked_emplace_back(key);
+            }
+            ::stack_vector::details::flat_sort_unique(_keys, &no_values, _comp);
+        }
+        constexpr void insert(::std::initializer_list<K> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        constexpr iterator erase(const_iterator pos) {
+            const size_type index = size_type(pos - begin());
+            _keys.erase(_keys.begin() + index);
+            return begin() + index;
+        }
+        constexpr size_type erase(const K &key) {
+            const size_type index = find_index(key);
+            if (index == size())
+                return 0;
+            _keys.erase(_keys.begin() + index);
+            return 1;
+        }
+        constexpr void clear() noexcept {
+            _keys.clear();
+        }
+        constexpr void swap(stack_flat_set &other) noexcept {
+            _keys.swap(other._keys);
+            ::std::swap(_comp, other._comp);
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const stack_flat_set &left, const stack_flat_set &right) {
+            return left._keys == right._keys;
+        }
+    };
+} // namespace stack_vector
@@ -1,6 +1,13 @@
 #pragma once
-#include <list>
+#include <bit>
+#include <concepts>
+#include <memory>
+#include <numeric>
 #include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+#include "block_pool.h"
 #include "stack_vector.h"
 
 /*
@@ -28,61 +35,249 @@ SOFTWARE.
 */
 
 namespace rope {
+	namespace details {
+		// chunk k holds first_chunk_capacity << k elements, so chunk k starts at
+		// first_chunk_capacity * (2^k - 1) and the chunk of any position is a bit scan away
+		constexpr size_t first_chunk_shift    = 3;
+		constexpr size_t first_chunk_capacity = size_t(1) << first_chunk_shift;
+		constexpr size_t max_chunks           = sizeof(size_t) * 8 - first_chunk_shift;
+
+		constexpr size_t chunk_index(size_t pos) noexcept {
+			return size_t(::std::bit_width((pos >> first_chunk_shift) + 1)) - 1;
+		}
+		constexpr size_t chunk_start(size_t chunk) noexcept {
+			return ((size_t(1) << chunk) - 1) << first_chunk_shift;
+		}
+		constexpr size_t chunk_capacity(size_t chunk) noexcept {
+			return first_chunk_capacity << chunk;
+		}
+
+		// a hint only, the hardware prefetcher follows along once a segment is being streamed
+		STACK_VECTOR_FORCEINLINE void prefetch(const void *ptr) noexcept {
+#if !defined(_MSC_VER)
+			__builtin_prefetch(ptr);
+#elif defined(_M_X64) || defined(_M_IX86)
+			_mm_prefetch((const char *)ptr, _MM_HINT_T0);
+#else
+			(void)ptr;
+#endif
+		}
+	} // namespace details
+
+	// element iterators over a container of contiguous segments (a rope's chunks, a block_rope's blocks),
+	// stepping within a segment is a pointer increment, only crossing into the next one looks it up
+	template <typename Container, bool Const> class segmented_iterator {
+		friend Container;
+		friend class segmented_iterator<Container, !Const>;
+		using rope_pointer = typename ::std::conditional<Const, const Container *, Container *>::type;
+		using size_type    = typename Container::size_type;
+		using T            = typename Container::value_type;
+		using T_pointer    = typename ::std::conditional<Const, const T *, T *>::type;
+
+		rope_pointer _rope    = nullptr;
+		size_type    _pos     = 0;
+		T_pointer    _cur     = nullptr;
+		T_pointer    _seg_end = nullptr;
+
+		constexpr segmented_iterator(rope_pointer r, size_type pos) noexcept : _rope(r), _pos(pos) {
+			seat();
+		}
+		constexpr void seat() noexcept {
+			if (_pos < _rope->size()) {
+				// a const rope hands out a span<const T>, only a mutable iterator sees the mutable segment
+				auto seg = _rope->segment_at(_pos);
+				_cur     = seg.data();
+				_seg_end = seg.data() + seg.size();
+			} else {
+				_cur = _seg_end = nullptr;
+			}
+		}
+
+	  public:
+		using iterator_category = ::std::random_access_iterator_tag;
+		using iterator_concept  = ::std::random_access_iterator_tag;
+		using value_type        = T;
+		using difference_type   = ::std::ptrdiff_t;
+		using pointer   = typename ::std::conditional<Const, const T *, T *>::type;
+		using reference = typename ::std::conditional<Const, const T &, T &>::type;
+
+		constexpr segmented_iterator() noexcept = default;
+		template <bool OtherConst>
+		constexpr segmented_iterator(const segmented_iterator<Container, OtherConst> &other) noexcept requires(Const && !OtherConst)
+		    : _rope(other._rope), _pos(other._pos), _cur(other._cur), _seg_end(other._seg_end) {
+		}
+
+		constexpr reference operator*() const noexcept {
+			return *_cur;
+		}
+		constexpr pointer operator->() const noexcept {
+			return _cur;
+		}
+		constexpr reference operator[](difference_type n) const noexcept {
+			return *(*this + n);
+		}
+		constexpr size_type index() const noexcept {
+			return _pos;
+		}
+		// the contiguous rest of the current segment, starting here
+		constexpr ::std::span<value_type> segment() const noexcept requires(!Const) {
+			return ::std::span<value_type>(_cur, _seg_end);
+		}
+		constexpr ::std::span<const value_type> segment() const noexcept requires(Const) {
+			return ::std::span<const value_type>(_cur, _seg_end);
+		}
+
+		constexpr segmented_iterator &operator++() noexcept {
+			++_pos;
+			if (++_cur == _seg_end)
+				seat();
+			return *this;
+		}
+		constexpr segmented_iterator operator++(int) noexcept {
+			segmented_iterator ret = *this;
+			++*this;
+			return ret;
+		}
+		constexpr segmented_iterator &operator--() noexcept {
+			return *this -= 1;
+		}
+		constexpr segmented_iterator operator--(int) noexcept {
+			segmented_iterator ret = *this;
+			--*this;
+			return ret;
+		}
+		constexpr segmented_iterator &operator+=(difference_type n) noexcept {
+			_pos = size_type(difference_type(_pos) + n);
+			seat();
+			return *this;
+		}
+		constexpr segmented_iterator &operator-=(difference_type n) noexcept {
+			return *this += -n;
+		}
+		friend constexpr segmented_iterator operator+(segmented_iterator it, difference_type n) noexcept {
+			return it += n;
+		}
+		friend constexpr segmented_iterator operator+(difference_type n, segmented_iterator it) noexcept {
+			return it += n;
+		}
+		friend constexpr segmented_iterator operator-(segmented_iterator it, difference_type n) noexcept {
+			return it -= n;
+		}
+		friend constexpr difference_type operator-(const segmented_iterator &left,
+		                                           const segmented_iterator &right) noexcept {
+			return difference_type(left._pos) - difference_type(right._pos);
+		}
+		friend constexpr bool operator==(const segmented_iterator &left, const segmented_iterator &right) noexcept {
+			return left._pos == right._pos;
+		}
+		friend constexpr auto operator<=>(const segmented_iterator &left, const segmented_iterator &right) noexcept {
+			return left._pos <=> right._pos;
+		}
+	};
+
+	// a growable sequence that never moves its elements, chunks double in size and are found through a
+	// fixed size directory
 	template <typename T> struct rope {
-	  private:
-		std::list<std::vector<T>> _internal_struct;
-		size_t                    _size;
-		size_t                    _capacity;
 	  public:
 		using value_type      = T;
-		using allocator_type  = std::list<std::vector<T>>::allocator_type;
-		using size_type       = std::list<std::vector<T>>::size_type;
-		using difference_type = std::list<std::vector<T>>::difference_type;
-		using reference       = std::vector<T>::reference;
-		using const_reference = std::list<std::vector<T>>::const_reference;
-		using pointer         = std::list<std::vector<T>>::pointer;
-		using const_pointer   = std::list<std::vector<T>>::const_pointer;
-		using iterator        = std::list<std::vector<T>>::iterator;
-		using const_iterator  = std::list<std::vector<T>>::const_iterator;
-		using reverse_iterator        = std::list<std::vector<T>>::reverse_iterator;
-		using const_reverse_iterator  = std::list<std::vector<T>>::const_reverse_iterator;
+		using allocator_type  = ::std::allocator<T>;
+		using size_type       = ::std::size_t;
+		using difference_type = ::std::ptrdiff_t;
+		using reference       = value_type &;
+		using const_reference = const value_type &;
+		using pointer         = value_type *;
+		using const_pointer   = const value_type *;
+
+		using iterator               = segmented_iterator<rope, false>;
+		using const_iterator         = segmented_iterator<rope, true>;
+		using reverse_iterator       = ::std::reverse_iterator<iterator>;
+		using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+	  private:
+		::stack_vector::stack_vector<pointer, details::max_chunks> _chunks;
+		size_t                                                     _size = 0;
+
+		static pointer allocate_chunk(size_t chunk) {
+			return allocator_type().allocate(details::chunk_capacity(chunk));
+		}
+		static void deallocate_chunk(pointer ptr, size_t chunk) {
+			allocator_type().deallocate(ptr, details::chunk_capacity(chunk));
+		}
+		// the first free slot, growing if there isn't one
+		pointer next_slot() {
+			if (_size == capacity())
+				grow();
+			const size_t chunk = details::chunk_index(_size);
+			return _chunks[chunk] + (_size - details::chunk_start(chunk));
+		}
+		void release() noexcept {
+			clear();
+			for (size_t chunk = 0; chunk < _chunks.size(); chunk++)
+				deallocate_chunk(_chunks[chunk], chunk);
+			_chunks.clear();
+		}
+
+	  public:
+		constexpr rope() noexcept = default;
+		rope(const rope &other) {
+			// the destructor doesn't run for a constructor that throws, a failed copy frees what it built
+			try {
+				reserve(other.size());
+				for (size_t pos = 0; pos < other.size(); pos++)
+					emplace_back(other[pos]);
+			} catch (...) {
+				release();
+				throw;
+			}
+		}
+		rope(rope &&other) noexcept : _chunks(other._chunks), _size(other._size) {
+			other._chunks.clear();
+			other._size = 0;
+		}
+		~rope() {
+			release();
+		}
+		rope &operator=(rope other) noexcept {
+			swap(other);
+			return *this;
+		}
+		void swap(rope &other) noexcept {
+			_chunks.swap(other._chunks);
+			::std::swap(_size, other._size);
+		}
 
 		constexpr reference front() {
-			return _internal_struct[0].front();
+			assert(_size && "front of an empty rope");
+			return _chunks[0][0];
 		}
 
 		constexpr const_reference front() const {
-			return _internal_struct[0].front();
+			assert(_size && "front of an empty rope");
+			return _chunks[0][0];
 		}
 
 		constexpr reference back() {
-			return _internal_struct.back().back();
+			return operator[](_size - 1);
 		}
 
 		constexpr const_reference back() const {
-			return _internal_struct.back().back();
+			return operator[](_size - 1);
 		}
 
 		constexpr reference operator[](size_type pos) {
 			assert(pos < _size && "index out of bounds");
-			for (auto &vect : _internal_struct) {
-				if (pos < vect.size()) {
-					return vect[pos];
-				}
-				pos -= vect.size();
-			}
-			return {};
+			const size_t chunk = details::chunk_index(pos);
+			return _chunks[chunk][pos - details::chunk_start(chunk)];
 		}
 
 		constexpr const_reference operator[](size_type pos) const {
 			assert(pos < _size && "index out of bounds");
-			for (auto &vect : _internal_struct) {
-				if (pos < vect.size()) {
-					return vect[pos];
-				}
-				pos -= vect.size();
-			}
-			return {};
+			const size_t chunk = details::chunk_index(pos);
+			return _chunks[chunk][pos - details::chunk_start(chunk)];
+		}
+
+		constexpr bool empty() const {
+			return _size == 0;
 		}
 
 		constexpr size_t size() const {
@@ -90,111 +285,313 @@ namespace rope {
 		}
 
 		constexpr size_t capacity() const {
-			return _capacity;
-		}
-
-		// add a new vector to the end to expand on
-		__forceinline constexpr void grow() {
-			auto &new_vec = _internal_struct.emplace_back();
-			new_vec.reserve(_capacity ? _capacity * 2 : 8);
-			_capacity += new_vec.capacity();
-		}
-		
-		template <class... Args>
-		constexpr reference emplace_back(Args &&...args) {
-			if (!_internal_struct.empty()) {
-				auto &last_struct = _internal_struct.back();
-				if (last_struct.size() == last_struct.capacity()) {
-					auto &new_vec = _internal_struct.emplace_back();
-					new_vec.reserve(_capacity ? _capacity * 2 : 8);
-					_capacity += new_vec.capacity();
-					new_vec.emplace_back(std::forward<Args>(args)...);
-				} else {
-					// technically shouldn't reallocate
-					_capacity -= last_struct.capacity();
-					_internal_struct.back().emplace_back(std::forward<Args>(args)...);
-					_capacity += last_struct.capacity();
-				}
+			return details::chunk_start(_chunks.size());
+		}
 
-			} else {
-				auto &new_vec = _internal_struct.emplace_back();
-				new_vec.reserve(_capacity ? _capacity * 2 : 8);
-				_capacity += new_vec.capacity();
-				new_vec.back().emplace_back(std::forward<Args>(args)...);
-			}
+		// the number of chunks and chunk k's elements, each chunk is contiguous
+		constexpr size_t chunk_count() const {
+			return _chunks.size();
+		}
+		constexpr ::std::span<T> chunk(size_t k) {
+			const size_t start = details::chunk_start(k);
+			return ::std::span<T>(_chunks[k], _size > start ? ::std::min(_size - start, details::chunk_capacity(k)) : 0);
+		}
+		constexpr ::std::span<const T> chunk(size_t k) const {
+			const size_t start = details::chunk_start(k);
+			return ::std::span<const T>(_chunks[k],
+			                            _size > start ? ::std::min(_size - start, details::chunk_capacity(k)) : 0);
+		}
+
+		// the chunks holding elements, as segments for the segment algorithms
+		constexpr size_t segment_count() const noexcept {
+			return _size ? details::chunk_index(_size - 1) + 1 : 0;
+		}
+		constexpr ::std::span<T> segment(size_t k) {
+			return chunk(k);
+		}
+		constexpr ::std::span<const T> segment(size_t k) const {
+			return chunk(k);
+		}
+		// the rest of the chunk holding pos, starting at pos
+		constexpr ::std::span<T> segment_at(size_type pos) noexcept {
+			const size_t chunk = details::chunk_index(pos);
+			const size_t start = details::chunk_start(chunk);
+			const size_t last  = ::std::min(_size, start + details::chunk_capacity(chunk));
+			return ::std::span<T>(_chunks[chunk] + (pos - start), last - pos);
+		}
+		constexpr ::std::span<const T> segment_at(size_type pos) const noexcept {
+			return const_cast<rope *>(this)->segment_at(pos);
+		}
+
+		constexpr iterator begin() noexcept {
+			return iterator(this, 0);
+		}
+		constexpr const_iterator begin() const noexcept {
+			return const_iterator(this, 0);
+		}
+		constexpr const_iterator cbegin() const noexcept {
+			return const_iterator(this, 0);
+		}
+		constexpr iterator end() noexcept {
+			return iterator(this, _size);
+		}
+		constexpr const_iterator end() const noexcept {
+			return const_iterator(this, _size);
+		}
+		constexpr const_iterator cend() const noexcept {
+			return const_iterator(this, _size);
+		}
+		constexpr reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+		constexpr const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+		constexpr reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+		constexpr const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		// add a new chunk to the end to expand on, existing elements stay where they are
+		STACK_VECTOR_FORCEINLINE void grow() {
+			assert(!_chunks.full() && "rope cannot grow any further");
+			_chunks.shove_back(allocate_chunk(_chunks.size()));
+		}
+
+		void reserve(size_type new_capacity) {
+			while (capacity() < new_capacity)
+				grow();
+		}
+
+		template <class... Args> reference emplace_back(Args &&...args) {
+			pointer slot = next_slot();
+			::new ((void *)slot) T(::std::forward<Args>(args)...);
 			_size += 1;
-		};
+			return *slot;
+		}
 
-		template <class... Args> constexpr const_reference emplace_back(Args &&...args) const {
-			if (!_internal_struct.empty()) {
-				auto &last_struct = _internal_struct.back();
-				if (last_struct.size() == last_struct.capacity()) {
-					auto &new_vec = _internal_struct.emplace_back();
-					new_vec.reserve(_capacity ? _capacity * 2 : 8);
-					_capacity += new_vec.capacity();
-					new_vec.emplace_back(std::forward<Args>(args)...);
-				} else {
-					// technically shouldn't reallocate
-					_capacity -= last_struct.capacity();
-					_internal_struct.back().emplace_back(std::forward<Args>(args)...);
-					_capacity += last_struct.capacity();
-				}
-			} else {
-				auto &new_vec = _internal_struct.emplace_back();
-				new_vec.reserve(_capacity ? _capacity * 2 : 8);
-				_capacity += new_vec.capacity();
-				new_vec.back().emplace_back(std::forward<Args>(args)...);
+		void push_back(const T &value) {
+			emplace_back(value);
+		}
+
+		void push_back(T &&value) {
+			emplace_back(::std::move(value));
+		}
+
+		void pop_back() {
+			assert(_size && "pop_back of an empty rope");
+			if constexpr (!::std::is_trivially_destructible<T>::value)
+				back().~T();
+			_size -= 1;
+		}
+
+		// destroys the elements, the chunks are kept
+		void clear() noexcept {
+			if constexpr (!::std::is_trivially_destructible<T>::value) {
+				for (size_t k = 0; k < _chunks.size(); k++)
+					::std::destroy(chunk(k).begin(), chunk(k).end());
 			}
-			_size += 1;
-		};
+			_size = 0;
+		}
+
+		// frees the chunks past the last element
+		void shrink_to_fit() noexcept {
+			const size_t used = _size ? details::chunk_index(_size - 1) + 1 : 0;
+			while (_chunks.size() > used) {
+				deallocate_chunk(_chunks.back(), _chunks.size() - 1);
+				_chunks.pop_back();
+			}
+		}
 	};
 
-	template <typename T, size_t rope_width> struct block_rope { private:
-		std::list<stack_vector::stack_vector<T, rope_width>> _internal_struct;
-		size_t                                               _size;
-		size_t                                               _capacity;
+	// a deque of fixed width blocks, found through a contiguous directory of block pointers. The elements
+	// start _front slots into the first block and run on contiguously, so a position's block is a shift
+	// away and both ends grow and shrink in O(1) without sliding anything.
+	template <typename T, size_t rope_width> struct block_rope {
+		static_assert(rope_width > 0 && (rope_width & (rope_width - 1)) == 0,
+		              "a block_rope<T,rope_width> must have a power of two rope_width");
+
 	  public:
+		// one block's slots, which of them hold elements is the block_rope's to track
+		struct block_type {
+			union {
+				T values[rope_width];
+			};
+			block_type() noexcept {
+			}
+			~block_type() {
+			}
+		};
+		using pool_type       = ::rope::block_pool_for<block_type>;
 		using value_type      = T;
-		using allocator_type  = std::list<std::vector<T>>::allocator_type;
-		using size_type       = std::list<std::vector<T>>::size_type;
-		using difference_type = std::list<std::vector<T>>::difference_type;
-		using reference       = std::vector<T>::reference;
-		using const_reference = std::list<std::vector<T>>::const_reference;
-		using pointer         = std::list<std::vector<T>>::pointer;
-		using const_pointer   = std::list<std::vector<T>>::const_pointer;
-		using iterator        = std::list<std::vector<T>>::iterator;
-		using const_iterator  = std::list<std::vector<T>>::const_iterator;
-		using reverse_iterator        = std::list<std::vector<T>>::reverse_iterator;
-		using const_reverse_iterator  = std::list<std::vector<T>>::const_reverse_iterator;
+		using size_type       = ::std::size_t;
+		using difference_type = ::std::ptrdiff_t;
+		using reference       = value_type &;
+		using const_reference = const value_type &;
+		using pointer         = value_type *;
+		using const_pointer   = const value_type *;
+
+		static constexpr size_t width_shift = size_t(::std::countr_zero(rope_width));
+		static constexpr size_t width_mask  = rope_width - 1;
+
+		using iterator               = segmented_iterator<block_rope, false>;
+		using const_iterator         = segmented_iterator<block_rope, true>;
+		using reverse_iterator       = ::std::reverse_iterator<iterator>;
+		using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+	  private:
+		// _map[_map_head, _map_head + _block_count) are the blocks in use, the elements are the slots
+		// [_front, _front + _size) counted from the first of them
+		::std::vector<block_type *> _map;
+		size_t                      _map_head    = 0;
+		size_t                      _block_count = 0;
+		size_t                      _front       = 0;
+		size_t                      _size        = 0;
+
+		// blocks come from a thread caching pool shared by every block_rope with the same block type
+		static block_type *allocate_block() {
+			return ::new (pool_type::instance().allocate()) block_type();
+		}
+		static void free_block(block_type *block) noexcept {
+			block->~block_type();
+			pool_type::instance().deallocate(block);
+		}
+
+		// the slot of the element at pos
+		constexpr pointer slot(size_type pos) const noexcept {
+			const size_type at = _front + pos;
+			return _map[_map_head + (at >> width_shift)]->values + (at & width_mask);
+		}
+
+		// make room for count more block pointers in front of or behind the used part of the directory
+		void make_map_room(bool at_front, size_t count = 1) {
+			const bool has_room =
+			    at_front ? _map_head >= count : (_map_head + _block_count + count) <= _map.size();
+			if (has_room)
+				return;
+			if ((_block_count + count) * 2 > _map.size()) {
+				// grow, keeping the blocks centered
+				size_t new_size = _map.size() ? _map.size() * 2 : 8;
+				while ((_block_count + count) * 2 > new_size)
+					new_size *= 2;
+				::std::vector<block_type *> new_map(new_size, nullptr);
+				const size_t                new_head = (new_map.size() - _block_count) / 2;
+				::std::copy_n(_map.begin() + _map_head, _block_count, new_map.begin() + new_head);
+				_map.swap(new_map);
+				_map_head = new_head;
+			} else {
+				// plenty of room on the other side, recenter
+				const size_t new_head = (_map.size() - _block_count) / 2;
+				if (new_head < _map_head)
+					::std::copy_n(_map.begin() + _map_head, _block_count, _map.begin() + new_head);
+				else
+					::std::copy_backward(_map.begin() + _map_head, _map.begin() + _map_head + _block_count,
+					                     _map.begin() + new_head + _block_count);
+				_map_head = new_head;
+			}
+		}
+		void push_block_back() {
+			make_map_room(false);
+			_map[_map_head + _block_count] = allocate_block();
+			_block_count += 1;
+		}
+		void push_block_front() {
+			make_map_room(true);
+			_map[_map_head - 1] = allocate_block();
+			_map_head -= 1;
+			_block_count += 1;
+		}
+		void pop_block_back() noexcept {
+			free_block(_map[_map_head + _block_count - 1]);
+			_block_count -= 1;
+		}
+		void pop_block_front() noexcept {
+			free_block(_map[_map_head]);
+			_map_head += 1;
+			_block_count -= 1;
+		}
+
+	  public:
+		constexpr block_rope() noexcept = default;
+		block_rope(const block_rope &other) {
+			try {
+				for (const auto &value : other)
+					emplace_back(value);
+			} catch (...) {
+				clear();
+				throw;
+			}
+		}
+		block_rope(block_rope &&other) noexcept
+		    : _map(::std::move(other._map)), _map_head(other._map_head), _block_count(other._block_count),
+		      _front(other._front), _size(other._size) {
+			other._map.clear();
+			other._map_head    = 0;
+			other._block_count = 0;
+			other._front       = 0;
+			other._size        = 0;
+		}
+		~block_rope() {
+			clear();
+		}
+		block_rope &operator=(block_rope other) noexcept {
+			swap(other);
+			return *this;
+		}
+		void swap(block_rope &other) noexcept {
+			_map.swap(other._map);
+			::std::swap(_map_head, other._map_head);
+			::std::swap(_block_count, other._block_count);
+			::std::swap(_front, other._front);
+			::std::swap(_size, other._size);
+		}
 
 		constexpr reference front() {
-			return _internal_struct[0].front();
+			assert(_size && "front of an empty block_rope");
+			return *slot(0);
 		}
 
 		constexpr const_reference front() const {
-			return _internal_struct[0].front();
+			assert(_size && "front of an empty block_rope");
+			return *slot(0);
 		}
 
 		constexpr reference back() {
-			return _internal_struct.back().back();
+			assert(_size && "back of an empty block_rope");
+			return *slot(_size - 1);
 		}
 
 		constexpr const_reference back() const {
-			return _internal_struct.back().back();
+			assert(_size && "back of an empty block_rope");
+			return *slot(_size - 1);
 		}
 
 		constexpr reference operator[](size_type pos) {
 			assert(pos < _size && "index out of bounds");
-			size_t value_idx = pos % rope_width;
-			size_t rope_idx  = pos / rope_width;
-			return _internal_struct[rope_idx][value_idx];
+			return *slot(pos);
 		}
 
 		constexpr const_reference operator[](size_type pos) const {
 			assert(pos < _size && "index out of bounds");
-			size_t value_idx = pos % rope_width;
-			size_t rope_idx  = pos / rope_width;
-			return _internal_struct[rope_idx][value_idx];
+			return *slot(pos);
+		}
+
+		constexpr reference at(size_type pos) {
+			if (pos >= _size)
+				throw ::std::out_of_range("block_rope index out of range");
+			return operator[](pos);
+		}
+
+		constexpr const_reference at(size_type pos) const {
+			if (pos >= _size)
+				throw ::std::out_of_range("block_rope index out of range");
+			return operator[](pos);
+		}
+
+		constexpr bool empty() const {
+			return _size == 0;
 		}
 
 		constexpr size_t size() const {
@@ -202,54 +599,273 @@ namespace rope {
 		}
 
 		constexpr size_t capacity() const {
-			return _capacity;
-		}
-
-		template <class... Args> constexpr reference emplace_back(Args &&...args) {
-			if (!_internal_struct.empty()) {
-				auto &last_struct = _internal_struct.back();
-				if (last_struct.size() == last_struct.capacity()) {
-					auto &new_vec = _internal_struct.emplace_back();
-					new_vec.reserve(_capacity ? _capacity * 2 : 8);
-					_capacity += new_vec.capacity();
-					new_vec.emplace_back(std::forward<Args>(args)...);
-				} else {
-					// technically shouldn't reallocate
-					_capacity -= last_struct.capacity();
-					_internal_struct.back().emplace_back(std::forward<Args>(args)...);
-					_capacity += last_struct.capacity();
-				}
+			return _block_count * rope_width;
+		}
 
-			} else {
-				auto &new_vec = _internal_struct.emplace_back();
-				new_vec.reserve(_capacity ? _capacity * 2 : 8);
-				_capacity += new_vec.capacity();
-				new_vec.back().emplace_back(std::forward<Args>(args)...);
+		// how many more elements push_back can take before it needs another block
+		constexpr size_t back_capacity() const noexcept {
+			return capacity() - _front - _size;
+		}
+
+		// the number of blocks and block k's elements, each block is contiguous
+		constexpr size_t block_count() const {
+			return _block_count;
+		}
+		constexpr ::std::span<T> block(size_t k) {
+			const size_t first = k ? 0 : _front;
+			const size_t last  = ::std::min(rope_width, _front + _size - (k << width_shift));
+			return ::std::span<T>(_map[_map_head + k]->values + first, last - first);
+		}
+		constexpr ::std::span<const T> block(size_t k) const {
+			return const_cast<block_rope *>(this)->block(k);
+		}
+		// the blocks, as segments for the segment algorithms
+		constexpr size_t segment_count() const noexcept {
+			return _block_count;
+		}
+		constexpr ::std::span<T> segment(size_t k) {
+			return block(k);
+		}
+		constexpr ::std::span<const T> segment(size_t k) const {
+			return block(k);
+		}
+		// the rest of the block holding pos, starting at pos
+		constexpr ::std::span<T> segment_at(size_type pos) noexcept {
+			const size_type at   = _front + pos;
+			const size_type last = ::std::min(rope_width, _front + _size - (at & ~width_mask));
+			return ::std::span<T>(slot(pos), last - (at & width_mask));
+		}
+		constexpr ::std::span<const T> segment_at(size_type pos) const noexcept {
+			return const_cast<block_rope *>(this)->segment_at(pos);
+		}
+
+		constexpr iterator begin() noexcept {
+			return iterator(this, 0);
+		}
+		constexpr const_iterator begin() const noexcept {
+			return const_iterator(this, 0);
+		}
+		constexpr const_iterator cbegin() const noexcept {
+			return const_iterator(this, 0);
+		}
+		constexpr iterator end() noexcept {
+			return iterator(this, _size);
+		}
+		constexpr const_iterator end() const noexcept {
+			return const_iterator(this, _size);
+		}
+		constexpr const_iterator cend() const noexcept {
+			return const_iterator(this, _size);
+		}
+		constexpr reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+		constexpr const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+		constexpr reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+		constexpr const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		template <class... Args> reference emplace_back(Args &&...args) {
+			const bool new_block = !back_capacity();
+			if (new_block)
+				push_block_back();
+			try {
+				pointer ret = ::std::construct_at(slot(_size), ::std::forward<Args>(args)...);
+				_size += 1;
+				return *ret;
+			} catch (...) {
+				if (new_block)
+					pop_block_back();
+				throw;
 			}
-			_size += 1;
-		};
+		}
 
-		template <class... Args> constexpr const_reference emplace_back(Args &&...args) const {
-			if (!_internal_struct.empty()) {
-				auto &last_struct = _internal_struct.back();
-				if (last_struct.size() == last_struct.capacity()) {
-					auto &new_vec = _internal_struct.emplace_back();
-					new_vec.reserve(_capacity ? _capacity * 2 : 8);
-					_capacity += new_vec.capacity();
-					new_vec.emplace_back(std::forward<Args>(args)...);
-				} else {
-					// technically shouldn't reallocate
-					_capacity -= last_struct.capacity();
-					_internal_struct.back().emplace_back(std::forward<Args>(args)...);
-					_capacity += last_struct.capacity();
+		void push_back(const T &value) {
+			emplace_back(value);
+		}
+
+		void push_back(T &&value) {
+			emplace_back(::std::move(value));
+		}
+
+		// a full first block gets a new block in front, filled from its back
+		template <class... Args> reference emplace_front(Args &&...args) {
+			const bool new_block = !_front;
+			if (new_block) {
+				push_block_front();
+				_front = rope_width;
+			}
+			try {
+				pointer ret = ::std::construct_at(_map[_map_head]->values + (_front - 1),
+				                                  ::std::forward<Args>(args)...);
+				_front -= 1;
+				_size += 1;
+				return *ret;
+			} catch (...) {
+				if (new_block) {
+					pop_block_front();
+					_front = 0;
 				}
-			} else {
-				auto &new_vec = _internal_struct.emplace_back();
-				new_vec.reserve(_capacity ? _capacity * 2 : 8);
-				_capacity += new_vec.capacity();
-				new_vec.back().emplace_back(std::forward<Args>(args)...);
+				throw;
 			}
-			_size += 1;
-		};
+		}
+
+		void push_front(const T &value) {
+			emplace_front(value);
+		}
+
+		void push_front(T &&value) {
+			emplace_front(::std::move(value));
+		}
+
+		void pop_back() {
+			assert(_size && "pop_back of an empty block_rope");
+			::std::destroy_at(slot(_size - 1));
+			_size -= 1;
+			if (back_capacity() == rope_width)
+				pop_block_back();
+			if (!_size)
+				clear();
+		}
+
+		void pop_front() {
+			assert(_size && "pop_front of an empty block_rope");
+			::std::destroy_at(slot(0));
+			_front += 1;
+			_size -= 1;
+			if (_front == rope_width) {
+				pop_block_front();
+				_front = 0;
+			}
+			if (!_size)
+				clear();
+		}
+
+		// moves other's elements onto the back, leaving it empty. When this ends on a block boundary and
+		// other's elements start on one the block pointers move over and no element is touched, otherwise
+		// the elements are moved one at a time.
+		void splice_back(block_rope &&other) {
+			if (this == &other || !other._size)
+				return;
+			if (back_capacity() || other._front) {
+				for (auto &value : other)
+					emplace_back(::std::move(value));
+				other.clear();
+				return;
+			}
+			// the only step that can throw, before either rope changes hands
+			make_map_room(false, other._block_count);
+			::std::copy_n(other._map.begin() + other._map_head, other._block_count,
+			              _map.begin() + _map_head + _block_count);
+			_block_count += other._block_count;
+			_size += other._size;
+			other._block_count = 0;
+			other._map_head    = other._map.size() / 2;
+			other._size        = 0;
+		}
+
+		// destroys the elements and frees every block, the directory is kept
+		void clear() noexcept {
+			for (size_t k = 0; k < _block_count; k++)
+				::std::destroy(block(k).begin(), block(k).end());
+			while (_block_count)
+				pop_block_back();
+			_map_head = _map.size() / 2;
+			_front    = 0;
+			_size     = 0;
+		}
+	};
+
+	// anything made of contiguous segments, rope's chunks and block_rope's blocks
+	template <typename R>
+	concept segmented_range = requires(R &r, size_t k) {
+		{ r.segment_count() } -> ::std::convertible_to<size_t>;
+		{ r.segment(k).data() };
+		{ r.segment(k).size() } -> ::std::convertible_to<size_t>;
+	};
+
+	namespace details {
+		// calls fn(segment, offset) on each segment while fn returns true, the next segment is
+		// prefetched before the current one is handed over
+		template <typename R, typename Fn> bool visit_segments(R &r, Fn &&fn) {
+			const size_t count  = r.segment_count();
+			size_t       offset = 0;
+			for (size_t k = 0; k < count; k++) {
+				auto seg = r.segment(k);
+				if (k + 1 < count)
+					prefetch(r.segment(k + 1).data());
+				if (!fn(seg, offset))
+					return false;
+				offset += seg.size();
+			}
+			return true;
+		}
+	} // namespace details
+
+	// segment wise algorithms, a tight contiguous loop per segment instead of an element iterator
+	// checking for the segment's end every step
+	template <segmented_range R, typename Fn> Fn for_each(R &r, Fn fn) {
+		details::visit_segments(r, [&fn](auto seg, size_t) {
+			for (auto &value : seg)
+				fn(value);
+			return true;
+		});
+		return fn;
+	}
+
+	template <segmented_range R, typename OutputIt> OutputIt copy(const R &r, OutputIt out) {
+		details::visit_segments(r, [&out](auto seg, size_t) {
+			out = ::std::copy(seg.begin(), seg.end(), out);
+			return true;
+		});
+		return out;
+	}
+
+	// the first element equal to value, or end()
+	template <segmented_range R, typename U> auto find(R &r, const U &value) {
+		size_t found = r.size();
+		details::visit_segments(r, [&](auto seg, size_t offset) {
+			auto it = ::std::find(seg.begin(), seg.end(), value);
+			if (it == seg.end())
+				return true;
+			found = offset + size_t(it - seg.begin());
+			return false;
+		});
+		return r.begin() + ::std::ptrdiff_t(found);
+	}
+
+	template <segmented_range R, typename U> size_t count(const R &r, const U &value) {
+		size_t ret = 0;
+		details::visit_segments(r, [&](auto seg, size_t) {
+			ret += size_t(::std::count(seg.begin(), seg.end(), value));
+			return true;
+		});
+		return ret;
+	}
+
+	template <segmented_range R, typename U, typename BinaryOp> U accumulate(const R &r, U init, BinaryOp op) {
+		details::visit_segments(r, [&](auto seg, size_t) {
+			init = ::std::accumulate(seg.begin(), seg.end(), ::std::move(init), op);
+			return true;
+		});
+		return init;
+	}
+
+	template <segmented_range R, typename U> U accumulate(const R &r, U init) {
+		return ::rope::accumulate(r, ::std::move(init), ::std::plus<>());
+	}
+
+	template <segmented_range R, typename OutputIt, typename UnaryOp>
+	OutputIt transform(const R &r, OutputIt out, UnaryOp op) {
+		details::visit_segments(r, [&](auto seg, size_t) {
+			out = ::std::transform(seg.begin(), seg.end(), out, op);
+			return true;
+		});
+		return out;
 	}
 } // namespace rope
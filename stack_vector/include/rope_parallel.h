@@ -0,0 +1,206 @@
+#pragma once
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <thread>
+#include "rope.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// each thread's share of a parallel call is cut into this many tasks, threads that finish early take
+// the tasks of slower ones
+#ifndef ROPE_PARALLEL_TASKS_PER_THREAD
+#define ROPE_PARALLEL_TASKS_PER_THREAD 4
+#endif
+
+// below this many elements per thread the work runs on the calling thread
+#ifndef ROPE_PARALLEL_MIN_ELEMENTS
+#define ROPE_PARALLEL_MIN_ELEMENTS 4096
+#endif
+
+namespace rope {
+	namespace details {
+		// threads = 0 asks for one per hardware thread
+		inline size_t thread_count(size_t threads, size_t elements) noexcept {
+			if (!threads)
+				threads = ::std::max<size_t>(1, ::std::thread::hardware_concurrency());
+			return ::std::max<size_t>(1, ::std::min(threads, elements / ROPE_PARALLEL_MIN_ELEMENTS));
+		}
+
+		// runs fn(task) for every task in [0, task_count) on threads threads (the caller is one of them),
+		// each thread takes the next task off a shared counter. The first exception is rethrown once all
+		// threads are done.
+		template <typename Fn> void parallel_tasks(size_t task_count, size_t threads, Fn &&fn) {
+			threads = ::std::min(threads, task_count);
+			if (threads <= 1) {
+				for (size_t task = 0; task < task_count; task++)
+					fn(task);
+				return;
+			}
+			::std::atomic<size_t> next_task = 0;
+			::std::atomic<bool>   failed    = false;
+			::std::exception_ptr  error;
+			auto                  work = [&] {
+				while (!failed.load(::std::memory_order_relaxed)) {
+					const size_t task = next_task.fetch_add(1, ::std::memory_order_relaxed);
+					if (task >= task_count)
+						break;
+					try {
+						fn(task);
+					} catch (...) {
+						if (!failed.exchange(true))
+							error = ::std::current_exception();
+					}
+				}
+			};
+			::std::vector<::std::thread> workers;
+			workers.reserve(threads - 1);
+			for (size_t t = 1; t < threads; t++)
+				workers.emplace_back(work);
+			work();
+			for (auto &worker : workers)
+				worker.join();
+			if (error)
+				::std::rethrow_exception(error);
+		}
+
+		// where slice task starts when size elements are cut into task_count even slices
+		inline size_t slice_start(size_t size, size_t task, size_t task_count) noexcept {
+			return size / task_count * task + ::std::min(task, size % task_count);
+		}
+
+		// calls fn(segment, offset) on the parts of r's segments inside [first, last)
+		template <typename R, typename Fn> void visit_slice(R &r, size_t first, size_t last, Fn &&fn) {
+			auto it = r.begin() + ::std::ptrdiff_t(first);
+			while (first < last) {
+				auto         seg   = it.segment();
+				const size_t count = ::std::min<size_t>(seg.size(), last - first);
+				fn(seg.first(count), first);
+				first += count;
+				it += ::std::ptrdiff_t(count);
+			}
+		}
+
+		// runs fn(segment, offset) over every element of r, sliced evenly across threads by element count
+		// (a rope's chunks double in size, so slicing by segment would leave one thread with half the work)
+		template <typename R, typename Fn> void parallel_slices(R &r, size_t threads, Fn &&fn) {
+			const size_t size = r.size();
+			threads           = thread_count(threads, size);
+			const size_t task_count =
+			    threads == 1 ? 1 : ::std::min(size, threads * size_t(ROPE_PARALLEL_TASKS_PER_THREAD));
+			if (!size)
+				return;
+			parallel_tasks(task_count, threads, [&](size_t task) {
+				visit_slice(r, slice_start(size, task, task_count), slice_start(size, task + 1, task_count), fn);
+			});
+		}
+	} // namespace details
+
+	// appends make(0) ... make(count - 1) to r's back, threads build whole blocks of their own which are
+	// then spliced on in order without moving any element. make is called concurrently.
+	template <typename T, size_t rope_width, typename Make>
+	void parallel_append_n(block_rope<T, rope_width> &r, size_t count, Make make, size_t threads = 0) {
+		// top up a short last block first so everything after starts on a block boundary
+		size_t index = 0;
+		for (const size_t room = r.back_capacity(); index < count && index < room; index++)
+			r.emplace_back(make(index));
+		const size_t remaining = count - index;
+		const size_t blocks    = (remaining + rope_width - 1) / rope_width;
+		threads                = details::thread_count(threads, remaining);
+		const size_t task_count =
+		    threads == 1 ? 1 : ::std::min(blocks, threads * size_t(ROPE_PARALLEL_TASKS_PER_THREAD));
+		if (!blocks)
+			return;
+
+		::std::vector<block_rope<T, rope_width>> parts(task_count);
+		details::parallel_tasks(task_count, threads, [&](size_t task) {
+			const size_t first = index + details::slice_start(blocks, task, task_count) * rope_width;
+			const size_t last =
+			    ::std::min(count, index + details::slice_start(blocks, task + 1, task_count) * rope_width);
+			for (size_t i = first; i < last; i++)
+				parts[task].emplace_back(make(i));
+		});
+		for (auto &part : parts)
+			r.splice_back(::std::move(part));
+	}
+
+	// appends [first, last) in parallel, see parallel_append_n
+	template <typename T, size_t rope_width, ::std::random_access_iterator It1>
+	void parallel_append(block_rope<T, rope_width> &r, It1 first, It1 last, size_t threads = 0) {
+		::rope::parallel_append_n(
+		    r, size_t(last - first), [first](size_t i) -> decltype(auto) { return first[::std::ptrdiff_t(i)]; },
+		    threads);
+	}
+
+	// fn on every element from several threads at once
+	template <segmented_range R, typename Fn> void parallel_for_each(R &r, Fn fn, size_t threads = 0) {
+		details::parallel_slices(r, threads, [&fn](auto seg, size_t) {
+			for (auto &value : seg)
+				fn(value);
+		});
+	}
+
+	// op of every element written to out at the element's position, out must be random access
+	template <segmented_range R, ::std::random_access_iterator OutputIt, typename UnaryOp>
+	OutputIt parallel_transform(const R &r, OutputIt out, UnaryOp op, size_t threads = 0) {
+		details::parallel_slices(r, threads, [&](auto seg, size_t offset) {
+			::std::transform(seg.begin(), seg.end(), out + ::std::ptrdiff_t(offset), op);
+		});
+		return out + ::std::ptrdiff_t(r.size());
+	}
+
+	// init combined with every element by op, which has to be associative as each slice is folded on its
+	// own before the slices are folded in order
+	template <segmented_range R, typename U, typename BinaryOp>
+	requires ::std::invocable<BinaryOp &, U, U>
+	U parallel_reduce(const R &r, U init, BinaryOp op, size_t threads = 0) {
+		const size_t size = r.size();
+		threads           = details::thread_count(threads, size);
+		if (threads == 1)
+			return ::rope::accumulate(r, ::std::move(init), op);
+		const size_t task_count = ::std::min(size, threads * size_t(ROPE_PARALLEL_TASKS_PER_THREAD));
+		::std::vector<::std::optional<U>> partials(task_count);
+		details::parallel_tasks(task_count, threads, [&](size_t task) {
+			::std::optional<U> &partial = partials[task];
+			auto fold = [&](auto seg, size_t) {
+				auto first = seg.begin();
+				if (!partial)
+					partial.emplace(*first++);
+				partial = ::std::accumulate(first, seg.end(), ::std::move(*partial), op);
+			};
+			details::visit_slice(r, details::slice_start(size, task, task_count),
+			                     details::slice_start(size, task + 1, task_count), fold);
+		});
+		for (auto &partial : partials) {
+			if (partial)
+				init = op(::std::move(init), ::std::move(*partial));
+		}
+		return init;
+	}
+
+	template <segmented_range R, typename U> U parallel_reduce(const R &r, U init, size_t threads = 0) {
+		return ::rope::parallel_reduce(r, ::std::move(init), ::std::plus<>(), threads);
+	}
+} // namespace rope
@@ -0,0 +1,297 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // up to N T's kept densely packed on the stack and reached through handles that stay valid until their
+    // element is erased. A handle names a slot and the slot's generation, erasing bumps the generation so
+    // stale handles miss. Insert and erase are O(1), erase moves the last element into the hole.
+    template <typename T, size_t N> struct stack_slot_map {
+        static_assert(N > 0, "a stack_slot_map<T,N> must have an N > 0");
+
+      public:
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using const_reference = const value_type &;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer         = element_type *;
+        using const_pointer   = const element_type *;
+        using reference       = element_type &;
+        using iterator        = pointer;
+        using const_iterator  = const_pointer;
+        using index_type      = ::stack_vector::details::smallest_size_t<N>;
+        using generation_type = ::std::uint32_t;
+
+        // generation 0 is never handed out, so a default constructed handle is always stale
+        struct handle {
+            index_type      index      = 0;
+            generation_type generation = 0;
+
+            friend constexpr bool operator==(const handle &left, const handle &right) noexcept = default;
+        };
+
+      private:
+        // a live slot holds its element's dense index, a free one the next free slot
+        struct slot {
+            index_type      position;
+            generation_type generation;
+        };
+        static constexpr index_type no_slot = index_type(N);
+
+        index_type                                   _size       = 0;
+        index_type                                   _slots_used = 0; // slots past this were never handed out
+        index_type                                   _free_head  = no_slot;
+        slot                                         _slots[N];
+        index_type                                   _dense_slot[N]; // which slot owns each dense element
+        ::stack_vector::details::inline_buffer<T, N> _dense;
+
+        [[nodiscard]] constexpr bool live(handle h) const noexcept {
+            return h.index < _slots_used && _slots[h.index].generation == h.generation;
+        }
+        constexpr void release(index_type s) noexcept {
+            _slots[s].generation += 1;
+            if (!_slots[s].generation) [[unlikely]]
+                _slots[s].generation = 1;
+            _slots[s].position = _free_head;
+            _free_head         = s;
+        }
+        // the slot the next insert takes, no_slot when full (after throwing if stack_vector's error handling
+        // says so)
+        constexpr index_type next_slot() const {
+            if (_size < N) [[likely]]
+                return _free_head != no_slot ? _free_head : _slots_used;
+            ::stack_vector::details::report_full("stack_slot_map cannot allocate to insert elements");
+            return no_slot;
+        }
+        constexpr void copy_from(const stack_slot_map &other) {
+            ::stack_vector::details::uninitialized_copy_n(other._dense.store.data(), other._size,
+                                                          _dense.store.data());
+            ::std::copy_n(other._slots, other._slots_used, _slots);
+            ::std::copy_n(other._dense_slot, other._size, _dense_slot);
+            _size       = other._size;
+            _slots_used = other._slots_used;
+            _free_head  = other._free_head;
+        }
+        constexpr void move_from(stack_slot_map &other) noexcept(
+            ::std::is_nothrow_move_constructible<T>::value) {
+            for (size_type i = 0; i < other._size; i++)
+                ::std::construct_at(_dense.store.data() + i, ::std::move(other._dense.store[i]));
+            ::std::copy_n(other._slots, other._slots_used, _slots);
+            ::std::copy_n(other._dense_slot, other._size, _dense_slot);
+            _size       = other._size;
+            _slots_used = other._slots_used;
+            _free_head  = other._free_head;
+        }
+
+      public:
+        // constructor's
+        constexpr stack_slot_map() noexcept {
+        }
+        constexpr stack_slot_map(const stack_slot_map &other) {
+            copy_from(other);
+        }
+        constexpr stack_slot_map(stack_slot_map &&other) noexcept(
+            ::std::is_nothrow_move_constructible<T>::value) {
+            move_from(other);
+            other.clear();
+        }
+        constexpr stack_slot_map &operator=(const stack_slot_map &other) {
+            if (this != &other) {
+                destroy_elements();
+                copy_from(other);
+            }
+            return *this;
+        }
+        constexpr stack_slot_map &operator=(stack_slot_map &&other) noexcept(
+            ::std::is_nothrow_move_constructible<T>::value) {
+            if (this != &other) {
+                destroy_elements();
+                move_from(other);
+                other.clear();
+            }
+            return *this;
+        }
+        constexpr ~stack_slot_map() requires ::std::is_trivially_destructible<T>::value = default;
+        constexpr ~stack_slot_map() {
+            destroy_elements();
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return !_size;
+        }
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size == N;
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _size;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return N;
+        }
+
+        // lookup by handle
+        [[nodiscard]] constexpr bool contains(handle h) const noexcept {
+            return live(h);
+        }
+        // the element h names, or nullptr if it was erased
+        [[nodiscard]] constexpr pointer find(handle h) noexcept {
+            return live(h) ? _dense.store.data() + _slots[h.index].position : nullptr;
+        }
+        [[nodiscard]] constexpr const_pointer find(handle h) const noexcept {
+            return live(h) ? _dense.store.data() + _slots[h.index].position : nullptr;
+        }
+        [[nodiscard]] constexpr reference operator[](handle h) noexcept {
+            assert(live(h));
+            return _dense.store[_slots[h.index].position];
+        }
+        [[nodiscard]] constexpr const_reference operator[](handle h) const noexcept {
+            assert(live(h));
+            return _dense.store[_slots[h.index].position];
+        }
+        [[nodiscard]] constexpr reference at(handle h) {
+            if (!live(h))
+                throw ::std::out_of_range("stack_slot_map handle is stale");
+            return _dense.store[_slots[h.index].position];
+        }
+        [[nodiscard]] constexpr const_reference at(handle h) const {
+            if (!live(h))
+                throw ::std::out_of_range("stack_slot_map handle is stale");
+            return _dense.store[_slots[h.index].position];
+        }
+        // the handle of the element at it, for going from dense iteration back to handles
+        [[nodiscard]] constexpr handle handle_of(const_iterator it) const noexcept {
+            const index_type s = _dense_slot[it - _dense.store.data()];
+            return handle{s, _slots[s].generation};
+        }
+
+        // dense access, the order changes on erase
+        [[nodiscard]] constexpr pointer data() noexcept {
+            return _dense.store.data();
+        }
+        [[nodiscard]] constexpr const_pointer data() const noexcept {
+            return _dense.store.data();
+        }
+        [[nodiscard]] constexpr ::std::span<T> values() noexcept {
+            return ::std::span<T>(_dense.store.data(), _size);
+        }
+        [[nodiscard]] constexpr ::std::span<const T> values() const noexcept {
+            return ::std::span<const T>(_dense.store.data(), _size);
+        }
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return _dense.store.data();
+        }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _dense.store.data();
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return _dense.store.data();
+        }
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return _dense.store.data() + _size;
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return _dense.store.data() + _size;
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return _dense.store.data() + _size;
+        }
+
+        // modifiers, inserting into a full map follows stack_vector's error handling and returns a stale
+        // handle
+        template <class... Args> constexpr handle emplace(Args &&...args) {
+            const index_type s = next_slot();
+            if (s == no_slot)
+                return handle{};
+            ::std::construct_at(_dense.store.data() + _size, ::std::forward<Args>(args)...);
+            if (s == _free_head) {
+                _free_head = _slots[s].position;
+            } else {
+                _slots[s].generation = 1;
+                _slots_used += 1;
+            }
+            _slots[s].position = _size;
+            _dense_slot[_size] = s;
+            _size += 1;
+            return handle{s, _slots[s].generation};
+        }
+        constexpr handle insert(const T &value) {
+            return emplace(value);
+        }
+        constexpr handle insert(T &&value) {
+            return emplace(::std::move(value));
+        }
+        // false if h was already stale
+        constexpr bool erase(handle h) noexcept(::std::is_nothrow_move_assignable<T>::value) {
+            if (!live(h))
+                return false;
+            const index_type position = _slots[h.index].position;
+            const index_type last     = index_type(_size - 1);
+            if (position != last) {
+                const index_type moved = _dense_slot[last];
+                _dense.store[position] = ::std::move(_dense.store[last]);
+                _dense_slot[position]  = moved;
+                _slots[moved].position = position;
+            }
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::stack_vector::details::destroy_at(_dense.store.data() + last);
+            _size = last;
+            release(h.index);
+            return true;
+        }
+        // erases the element at it, the last element takes its place so it ends up pointing at the next one
+        // to visit
+        constexpr iterator erase(const_iterator it) noexcept(::std::is_nothrow_move_assignable<T>::value) {
+            const size_type position = size_type(it - _dense.store.data());
+            erase(handle_of(it));
+            return _dense.store.data() + position;
+        }
+        // every handle goes stale
+        constexpr void clear() noexcept {
+            for (size_type i = 0; i < _size; i++)
+                release(_dense_slot[i]);
+            destroy_elements();
+        }
+        constexpr void swap(stack_slot_map &other) noexcept(::std::is_nothrow_move_constructible<T>::value) {
+            stack_slot_map tmp(::std::move(other));
+            other = ::std::move(*this);
+            *this = ::std::move(tmp);
+        }
+
+      private:
+        constexpr void destroy_elements() noexcept {
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::stack_vector::details::destroy(_dense.store.data(), _dense.store.data() + _size);
+            _size = 0;
+        }
+    };
+} // namespace stack_vector
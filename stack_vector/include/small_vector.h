@@ -0,0 +1,521 @@
+#pragma once
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // a stack_vector that moves its elements to the heap instead of failing when it runs out of room,
+    // growing geometrically from there
+    template <typename T, size_t N> struct small_vector {
+        static_assert(N > 0, "a small_vector<T,N> must have an N > 0");
+
+      public:
+        using element_type           = T;
+        using value_type             = typename ::std::remove_cv<T>::type;
+        using allocator_type         = ::std::allocator<value_type>;
+        using const_reference        = const value_type &;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using pointer                = element_type *;
+        using const_pointer          = const element_type *;
+        using reference              = element_type &;
+        using iterator               = pointer;
+        using const_iterator         = const_pointer;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type inline_capacity = N;
+
+      private:
+        pointer                                   _data;
+        size_type                                 _size     = 0;
+        size_type                                 _capacity = N;
+        ::stack_vector::details::inline_buffer<T, N> _inline;
+
+        pointer inline_data() noexcept {
+            return _inline.store.data();
+        }
+        // moves count T's into uninitialized dest, the originals are destroyed
+        static void relocate(pointer first, size_type count, pointer dest) {
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::relocate_n(first, count, dest);
+            } else {
+                if constexpr (::std::is_nothrow_move_constructible<T>::value ||
+                              !::std::is_copy_constructible<T>::value) {
+                    ::stack_vector::details::uninitialized_move_n(first, count, dest);
+                } else {
+                    // a throwing move would leave both buffers half done, copy instead
+                    ::stack_vector::details::uninitialized_copy_n(first, count, dest);
+                }
+                ::stack_vector::details::destroy(first, first + count);
+            }
+        }
+        void release() noexcept {
+            if (!is_inline())
+                allocator_type().deallocate(_data, _capacity);
+        }
+        void shrink_to(size_type count) noexcept {
+            if constexpr (!::std::is_trivially_destructible<T>::value) {
+                ::stack_vector::details::destroy(begin() + count, end());
+            }
+            _size = count;
+        }
+        // moves the elements to a buffer of new_capacity (at least size()), the inline one when it fits
+        void reallocate(size_type new_capacity) {
+            pointer buffer = new_capacity <= N ? inline_data() : allocator_type().allocate(new_capacity);
+            if (buffer == _data)
+                return;
+            if (new_capacity <= N)
+                new_capacity = N;
+            try {
+                relocate(_data, _size, buffer);
+            } catch (...) {
+                if (buffer != inline_data())
+                    allocator_type().deallocate(buffer, new_capacity);
+                throw;
+            }
+            release();
+            _data     = buffer;
+            _capacity = new_capacity;
+        }
+        size_type grown_capacity(size_type needed) const {
+            if (needed > max_size())
+                throw ::std::length_error("small_vector cannot grow past max_size()");
+            return ::std::max(needed, _capacity > max_size() / 2 ? max_size() : _capacity * 2);
+        }
+        // the first new element is built in the new buffer before the old one is given up, args may
+        // refer to an element
+        template <class... Args> reference grow_emplace_back(Args &&...args) {
+            const size_type new_capacity = grown_capacity(_size + 1);
+            pointer         buffer       = allocator_type().allocate(new_capacity);
+            try {
+                ::std::construct_at(buffer + _size, ::std::forward<Args>(args)...);
+            } catch (...) {
+                allocator_type().deallocate(buffer, new_capacity);
+                throw;
+            }
+            try {
+                relocate(_data, _size, buffer);
+            } catch (...) {
+                ::stack_vector::details::destroy_at(buffer + _size);
+                allocator_type().deallocate(buffer, new_capacity);
+                throw;
+            }
+            release();
+            _data     = buffer;
+            _capacity = new_capacity;
+            return _data[_size++];
+        }
+        // room for count more elements, growing geometrically
+        void reserve_more(size_type count) {
+            if (count > _capacity - _size)
+                reallocate(grown_capacity(_size + count));
+        }
+        // an uninitialized gap of count at index, fill constructs into it, closing it again on failure
+        template <class Fill> iterator insert_gap(size_type index, size_type count, Fill &&fill) {
+            reserve_more(count);
+            pointer pos = _data + index;
+            ::stack_vector::details::open_gap(pos, end(), count);
+            try {
+                fill(pos, count);
+            } catch (...) {
+                ::stack_vector::details::close_gap(pos, end() + count, count);
+                throw;
+            }
+            _size += count;
+            return pos;
+        }
+
+      public:
+        // constructor's
+        // _data is set here rather than in the initializer list, _inline isn't constructed until after it
+        small_vector() noexcept {
+            _data = inline_data();
+        }
+        small_vector(size_type count, const T &value) : small_vector() {
+            assign(count, value);
+        }
+        explicit small_vector(size_type count) : small_vector() {
+            resize(count);
+        }
+        template <::std::input_iterator It1> small_vector(It1 first, It1 last) : small_vector() {
+            append(first, last);
+        }
+        small_vector(::std::initializer_list<T> init) : small_vector() {
+            append(init.begin(), init.end());
+        }
+        small_vector(const small_vector &other) : small_vector() {
+            append(other.begin(), other.end());
+        }
+        // a heap buffer is taken over, inline elements are moved across, other is left empty
+        small_vector(small_vector &&other) noexcept(::std::is_nothrow_move_constructible<T>::value ||
+                                                    ::stack_vector::is_trivially_relocatable_v<T>)
+            : small_vector() {
+            take(other);
+        }
+
+        // destructor
+        ~small_vector() {
+            ::stack_vector::details::destroy(begin(), end());
+            release();
+        }
+
+        // operator ='s
+        small_vector &operator=(const small_vector &other) {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+        small_vector &operator=(small_vector &&other) noexcept(::std::is_nothrow_move_constructible<T>::value ||
+                                                               ::stack_vector::is_trivially_relocatable_v<T>) {
+            if (this != &other) {
+                clear();
+                release();
+                _data     = inline_data();
+                _capacity = N;
+                take(other);
+            }
+            return *this;
+        }
+        small_vector &operator=(::std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+            return *this;
+        }
+
+      private:
+        // this is empty and inline
+        void take(small_vector &other) {
+            if (!other.is_inline()) {
+                _data           = other._data;
+                _capacity       = other._capacity;
+                _size           = other._size;
+                other._data     = other.inline_data();
+                other._capacity = N;
+                other._size     = 0;
+            } else if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // a small inline buffer goes whole, a copy of a fixed size the compiler can unroll, a larger
+                // one only its live elements
+                if constexpr ((sizeof(T) * N) <= STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES)
+                    ::stack_vector::details::relocate_n(other.inline_data(), N, inline_data());
+                else
+                    ::stack_vector::details::relocate_n(other.inline_data(), other._size, inline_data());
+                _size       = other._size;
+                other._size = 0;
+            } else {
+                ::stack_vector::details::uninitialized_move_n(other._data, other._size, _data);
+                _size = other._size;
+                other.clear();
+            }
+        }
+
+      public:
+        // assign's
+        void assign(size_type count, const T &value) {
+            clear();
+            append(count, value);
+        }
+        template <::std::input_iterator It1> void assign(It1 first, It1 last) {
+            clear();
+            append(first, last);
+        }
+        void assign(::std::initializer_list<T> ilist) {
+            assign(ilist.begin(), ilist.end());
+        }
+
+        // element access
+        reference at(size_type pos) {
+            if (pos >= size())
+                throw ::std::out_of_range("small_vector index out of range");
+            return _data[pos];
+        }
+        const_reference at(size_type pos) const {
+            if (pos >= size())
+                throw ::std::out_of_range("small_vector index out of range");
+            return _data[pos];
+        }
+        reference operator[](size_type pos) noexcept {
+            assert(pos < size() && "index out of bounds");
+            return _data[pos];
+        }
+        const_reference operator[](size_type pos) const noexcept {
+            assert(pos < size() && "index out of bounds");
+            return _data[pos];
+        }
+        reference front() noexcept {
+            return operator[](0);
+        }
+        const_reference front() const noexcept {
+            return operator[](0);
+        }
+        reference back() noexcept {
+            return operator[](_size - 1);
+        }
+        const_reference back() const noexcept {
+            return operator[](_size - 1);
+        }
+        pointer data() noexcept {
+            return _data;
+        }
+        const_pointer data() const noexcept {
+            return _data;
+        }
+
+        // iterators
+        iterator begin() noexcept {
+            return _data;
+        }
+        const_iterator begin() const noexcept {
+            return _data;
+        }
+        const_iterator cbegin() const noexcept {
+            return _data;
+        }
+        iterator end() noexcept {
+            return _data + _size;
+        }
+        const_iterator end() const noexcept {
+            return _data + _size;
+        }
+        const_iterator cend() const noexcept {
+            return _data + _size;
+        }
+        reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+        const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        // capacity
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+        size_type size() const noexcept {
+            return _size;
+        }
+        size_type max_size() const noexcept {
+            return ::std::allocator_traits<allocator_type>::max_size(allocator_type());
+        }
+        size_type capacity() const noexcept {
+            return _capacity;
+        }
+        // whether the elements are still in the inline buffer (no allocation has been made)
+        bool is_inline() const noexcept {
+            return _data == _inline.store.data();
+        }
+        void reserve(size_type new_capacity) {
+            if (new_capacity > _capacity)
+                reallocate(new_capacity);
+        }
+        // back to the inline buffer when the elements fit, otherwise to an exact size heap buffer
+        void shrink_to_fit() {
+            if (!is_inline() && _size < _capacity)
+                reallocate(_size);
+        }
+
+        // modifiers
+        void clear() noexcept {
+            shrink_to(0);
+        }
+
+        template <class... Args> reference emplace_back(Args &&...args) {
+            if (_size == _capacity) [[unlikely]]
+                return grow_emplace_back(::std::forward<Args>(args)...);
+            ::std::construct_at(_data + _size, ::std::forward<Args>(args)...);
+            return _data[_size++];
+        }
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+        void push_back(T &&value) {
+            emplace_back(::std::move(value));
+        }
+        void pop_back() noexcept {
+            assert(_size && "pop_back of an empty small_vector");
+            shrink_to(_size - 1);
+        }
+
+        void append(size_type count, const T &value) {
+            if (count > _capacity - _size) {
+                value_type copy(value);
+                reserve_more(count);
+                ::stack_vector::details::uninitialized_fill_n(end(), count, copy);
+            } else {
+                ::stack_vector::details::uninitialized_fill_n(end(), count, value);
+            }
+            _size += count;
+        }
+        template <::std::input_iterator It1> void append(It1 first, It1 last) {
+            if constexpr (::std::forward_iterator<It1>) {
+                const size_type count = size_type(::std::distance(first, last));
+                reserve_more(count);
+                ::stack_vector::details::uninitialized_copy_n(first, count, end());
+                _size += count;
+            } else {
+                for (; first != last; ++first)
+                    emplace_back(*first);
+            }
+        }
+
+        template <class... Args> iterator emplace(const_iterator pos, Args &&...args) {
+            assert(pos >= cbegin() && pos <= cend() && "insert iterator is out of bounds of the small_vector");
+            const size_type index = size_type(pos - cbegin());
+            if (index == _size) {
+                emplace_back(::std::forward<Args>(args)...);
+                return begin() + index;
+            }
+            // built before anything moves, args may refer to an element
+            value_type value(::std::forward<Args>(args)...);
+            return insert_gap(index, 1, [&value](pointer dest, size_type) {
+                ::std::construct_at(dest, ::std::move(value));
+            });
+        }
+        iterator insert(const_iterator pos, const T &value) {
+            return emplace(pos, value);
+        }
+        iterator insert(const_iterator pos, T &&value) {
+            return emplace(pos, ::std::move(value));
+        }
+        iterator insert(const_iterator pos, size_type count, const T &value) {
+            const size_type index = size_type(pos - cbegin());
+            if (!count)
+                return begin() + index;
+            value_type copy(value);
+            return insert_gap(index, count, [&copy](pointer dest, size_type n) {
+                ::stack_vector::details::uninitialized_fill_n(dest, n, copy);
+            });
+        }
+        template <::std::input_iterator It1> iterator insert(const_iterator pos, It1 first, It1 last) {
+            const size_type index = size_type(pos - cbegin());
+            if constexpr (::std::forward_iterator<It1>) {
+                const size_type count = size_type(::std::distance(first, last));
+                if (!count)
+                    return begin() + index;
+                return insert_gap(index, count, [&first](pointer dest, size_type n) {
+                    ::stack_vector::details::uninitialized_copy_n(first, n, dest);
+                });
+            } else {
+                const size_type old_size = _size;
+                for (; first != last; ++first)
+                    emplace_back(*first);
+                ::std::rotate(begin() + index, begin() + old_size, end());
+                return begin() + index;
+            }
+        }
+        iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
+            return insert(pos, ilist.begin(), ilist.end());
+        }
+
+        iterator erase(const_iterator pos) noexcept(::std::is_nothrow_move_assignable<T>::value) {
+            return erase(pos, pos + 1);
+        }
+        iterator erase(const_iterator first, const_iterator last) noexcept(::std::is_nothrow_move_assignable<T>::value) {
+            assert(first >= cbegin() && first <= last && last <= cend() && "erase range is out of bounds");
+            pointer         pos   = begin() + (first - cbegin());
+            const size_type count = size_type(last - first);
+            if (!count)
+                return pos;
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::destroy(pos, pos + count);
+                ::stack_vector::details::relocate_n(pos + count, size_type(end() - (pos + count)), pos);
+                _size -= count;
+            } else {
+                ::std::move(pos + count, end(), pos);
+                shrink_to(_size - count);
+            }
+            return pos;
+        }
+
+        void resize(size_type count) {
+            if (count <= _size) {
+                shrink_to(count);
+                return;
+            }
+            reserve_more(count - _size);
+            ::std::uninitialized_value_construct(end(), begin() + count);
+            _size = count;
+        }
+        void resize(size_type count, const value_type &value) {
+            if (count <= _size)
+                shrink_to(count);
+            else
+                append(count - _size, value);
+        }
+
+        void swap(small_vector &other) noexcept(::std::is_nothrow_move_constructible<T>::value ||
+                                                ::stack_vector::is_trivially_relocatable_v<T>) {
+            if (this == &other)
+                return;
+            if (!is_inline() && !other.is_inline()) {
+                ::std::swap(_data, other._data);
+                ::std::swap(_size, other._size);
+                ::std::swap(_capacity, other._capacity);
+                return;
+            }
+            small_vector tmp(::std::move(other));
+            other = ::std::move(*this);
+            *this = ::std::move(tmp);
+        }
+    };
+} // namespace stack_vector
+
+// non-members
+template <class T, size_t N0, size_t N1>
+[[nodiscard]] bool operator==(const stack_vector::small_vector<T, N0> &left,
+                              const stack_vector::small_vector<T, N1> &right) {
+    return ::std::equal(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template <class T, size_t N0, size_t N1>
+[[nodiscard]] auto operator<=>(const stack_vector::small_vector<T, N0> &left,
+                               const stack_vector::small_vector<T, N1> &right) {
+    return ::std::lexicographical_compare_three_way(left.begin(), left.end(), right.begin(), right.end());
+}
+
+namespace std {
+    // conditional erases
+    template <class T, size_t N, class U>
+    typename stack_vector::small_vector<T, N>::size_type erase(stack_vector::small_vector<T, N> &c,
+                                                               const U &value) {
+        return ::stack_vector::details::erase_value(c, value);
+    }
+
+    template <class T, size_t N, class Pred>
+    typename stack_vector::small_vector<T, N>::size_type erase_if(stack_vector::small_vector<T, N> &c, Pred pred) {
+        return ::stack_vector::details::erase_value_if(c, pred);
+    }
+
+    template <class T, size_t N>
+    void swap(::stack_vector::small_vector<T, N> &left,
+              ::stack_vector::small_vector<T, N> &right) noexcept(noexcept(left.swap(right))) {
+        left.swap(right);
+    }
+}; // namespace std
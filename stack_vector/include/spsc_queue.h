@@ -0,0 +1,194 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // a bounded single producer / single consumer queue of at least N T's in inline storage, lock free and
+    // never allocating. One thread may push and one (other) thread may pop, N is rounded up to a power of
+    // two so the ever increasing indices wrap with a mask.
+    template <typename T, size_t N> struct spsc_queue {
+        static_assert(N > 0, "a spsc_queue<T,N> must have an N > 0");
+
+      public:
+        using value_type = T;
+        using size_type  = ::std::size_t;
+
+        static constexpr size_type ring_capacity = ::std::bit_ceil(N);
+
+      private:
+        static constexpr size_type mask = ring_capacity - 1;
+
+        // the consumer's line: where it reads next, and the last tail it saw so it only touches the
+        // producer's line when the queue looks empty
+        alignas(STACK_VECTOR_CACHE_LINE_SIZE)::std::atomic<size_type> _head = 0;
+        size_type _cached_tail                                              = 0;
+        // the producer's line, the mirror image
+        alignas(STACK_VECTOR_CACHE_LINE_SIZE)::std::atomic<size_type> _tail = 0;
+        size_type _cached_head                                              = 0;
+        alignas(STACK_VECTOR_CACHE_LINE_SIZE)::stack_vector::details::inline_buffer<T, ring_capacity> _ring;
+
+        [[nodiscard]] T *slot(size_type index) noexcept {
+            return _ring.store.data() + (index & mask);
+        }
+        // producer side, how many of count slots are free, refreshing the head only when needed
+        size_type free_slots(size_type tail, size_type count) noexcept {
+            size_type room = ring_capacity - (tail - _cached_head);
+            if (room < count) {
+                _cached_head = _head.load(::std::memory_order_acquire);
+                room         = ring_capacity - (tail - _cached_head);
+            }
+            return room;
+        }
+        // consumer side, how many of count slots are filled, refreshing the tail only when needed
+        size_type filled_slots(size_type head, size_type count) noexcept {
+            size_type ready = _cached_tail - head;
+            if (ready < count) {
+                _cached_tail = _tail.load(::std::memory_order_acquire);
+                ready        = _cached_tail - head;
+            }
+            return ready;
+        }
+
+      public:
+        constexpr spsc_queue() noexcept {
+        }
+        spsc_queue(const spsc_queue &)            = delete;
+        spsc_queue &operator=(const spsc_queue &) = delete;
+        ~spsc_queue() {
+            if constexpr (!::std::is_trivially_destructible<T>::value) {
+                const size_type tail = _tail.load(::std::memory_order_acquire);
+                for (size_type head = _head.load(::std::memory_order_relaxed); head != tail; ++head)
+                    ::stack_vector::details::destroy_at(slot(head));
+            }
+        }
+
+        [[nodiscard]] static constexpr size_type capacity() noexcept {
+            return ring_capacity;
+        }
+        // exact from either end when the other isn't running, a snapshot otherwise
+        [[nodiscard]] size_type size_approx() const noexcept {
+            const size_type head = _head.load(::std::memory_order_acquire);
+            return _tail.load(::std::memory_order_acquire) - head;
+        }
+        [[nodiscard]] bool empty() const noexcept {
+            return size_approx() == 0;
+        }
+
+        // producer, false (nothing constructed) when the queue is full
+        template <class... Args> bool try_emplace(Args &&...args) {
+            const size_type tail = _tail.load(::std::memory_order_relaxed);
+            if (!free_slots(tail, 1))
+                return false;
+            ::new ((void *)slot(tail)) T(::std::forward<Args>(args)...);
+            _tail.store(tail + 1, ::std::memory_order_release);
+            return true;
+        }
+        bool try_push(const T &value) {
+            return try_emplace(value);
+        }
+        bool try_push(T &&value) {
+            return try_emplace(::std::move(value));
+        }
+        // producer, copies as many of the values as fit in (at most) two contiguous runs and publishes them
+        // together, returns how many went in. If a copy throws nothing is published
+        size_type try_push_n(const T *values, size_type count) {
+            const size_type tail = _tail.load(::std::memory_order_relaxed);
+            count                = ::std::min(count, free_slots(tail, count));
+            if (!count)
+                return 0;
+            const size_type offset      = tail & mask;
+            const size_type first_count = ::std::min(count, ring_capacity - offset);
+            T *first = _ring.store.data() + offset;
+            ::stack_vector::details::uninitialized_copy_n(values, first_count, first);
+            try {
+                // a throwing run cleans up after itself, the run before it is ours to destroy
+                ::stack_vector::details::uninitialized_copy_n(values + first_count, count - first_count,
+                                                              _ring.store.data());
+            } catch (...) {
+                ::stack_vector::details::destroy(first, first + first_count);
+                throw;
+            }
+            _tail.store(tail + count, ::std::memory_order_release);
+            return count;
+        }
+        size_type try_push_n(::std::span<const T> values) {
+            return try_push_n(values.data(), values.size());
+        }
+
+        // consumer, false (out untouched) when the queue is empty
+        bool try_pop(T &out) {
+            const size_type head = _head.load(::std::memory_order_relaxed);
+            if (!filled_slots(head, 1))
+                return false;
+            T *value = slot(head);
+            out      = ::std::move(*value);
+            ::stack_vector::details::destroy_at(value);
+            _head.store(head + 1, ::std::memory_order_release);
+            return true;
+        }
+        // consumer, moves up to count values into out in (at most) two contiguous runs and frees their slots
+        // together, returns how many came out. If a move throws the values before it are still popped
+        size_type try_pop_n(T *out, size_type count) {
+            const size_type head = _head.load(::std::memory_order_relaxed);
+            count                = ::std::min(count, filled_slots(head, count));
+            if (!count)
+                return 0;
+            if constexpr (!::std::is_nothrow_move_assignable<T>::value) {
+                // one at a time, so a throw leaves every slot either still queued or already freed
+                size_type popped = 0;
+                try {
+                    for (; popped < count; popped++) {
+                        T *value    = slot(head + popped);
+                        out[popped] = ::std::move(*value);
+                        ::stack_vector::details::destroy_at(value);
+                    }
+                } catch (...) {
+                    _head.store(head + popped, ::std::memory_order_release);
+                    throw;
+                }
+                _head.store(head + count, ::std::memory_order_release);
+                return count;
+            }
+            const size_type offset      = head & mask;
+            const size_type first_count = ::std::min(count, ring_capacity - offset);
+            T              *first       = _ring.store.data() + offset;
+            T              *second      = _ring.store.data();
+            ::std::move(first, first + first_count, out);
+            ::std::move(second, second + (count - first_count), out + first_count);
+            if constexpr (!::std::is_trivially_destructible<T>::value) {
+                ::stack_vector::details::destroy(first, first + first_count);
+                ::stack_vector::details::destroy(second, second + (count - first_count));
+            }
+            _head.store(head + count, ::std::memory_order_release);
+            return count;
+        }
+        size_type try_pop_n(::std::span<T> out) {
+            return try_pop_n(out.data(), out.size());
+        }
+    };
+} // namespace stack_vector
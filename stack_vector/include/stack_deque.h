@@ -0,0 +1,381 @@
+#pragma once
+#include <bit>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // a ring buffer of at least N T's on the stack, N is rounded up to a power of two so wrapping is a mask,
+    // both ends push and pop in O(1)
+    template <typename T, size_t N> struct stack_deque {
+        static_assert(N > 0, "a stack_deque<T,N> must have an N > 0");
+
+      public:
+        using element_type    = T;
+        using value_type      = typename ::std::remove_cv<T>::type;
+        using const_reference = const value_type &;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+        using pointer         = element_type *;
+        using const_pointer   = const element_type *;
+        using reference       = element_type &;
+
+        static constexpr size_type ring_capacity = ::std::bit_ceil(N);
+
+        // an index into the deque, wrapped into the ring on dereference
+        template <bool Const> class basic_iterator {
+            friend struct stack_deque;
+            friend class basic_iterator<!Const>;
+            using deque_pointer = typename ::std::conditional<Const, const stack_deque *, stack_deque *>::type;
+
+            deque_pointer _deque = nullptr;
+            size_type     _index = 0;
+
+            constexpr basic_iterator(deque_pointer deque, size_type index) noexcept : _deque(deque), _index(index) {
+            }
+
+          public:
+            using iterator_category = ::std::random_access_iterator_tag;
+            using value_type        = typename stack_deque::value_type;
+            using difference_type   = ::std::ptrdiff_t;
+            using reference         = typename ::std::conditional<Const, const T &, T &>::type;
+            using pointer           = typename ::std::conditional<Const, const T *, T *>::type;
+
+            constexpr basic_iterator() noexcept = default;
+            template <bool OtherConst>
+            constexpr basic_iterator(const basic_iterator<OtherConst> &other) noexcept requires(Const && !OtherConst)
+                : _deque(other._deque), _index(other._index) {
+            }
+
+            constexpr reference operator*() const noexcept {
+                return (*_deque)[_index];
+            }
+            constexpr pointer operator->() const noexcept {
+                return ::std::addressof((*_deque)[_index]);
+            }
+            constexpr reference operator[](difference_type n) const noexcept {
+                return (*_deque)[size_type(difference_type(_index) + n)];
+            }
+
+            constexpr basic_iterator &operator++() noexcept {
+                ++_index;
+                return *this;
+            }
+            constexpr basic_iterator operator++(int) noexcept {
+                basic_iterator ret = *this;
+                ++_index;
+                return ret;
+            }
+            constexpr basic_iterator &operator--() noexcept {
+                --_index;
+                return *this;
+            }
+            constexpr basic_iterator operator--(int) noexcept {
+                basic_iterator ret = *this;
+                --_index;
+                return ret;
+            }
+            constexpr basic_iterator &operator+=(difference_type n) noexcept {
+                _index = size_type(difference_type(_index) + n);
+                return *this;
+            }
+            constexpr basic_iterator &operator-=(difference_type n) noexcept {
+                return *this += -n;
+            }
+            friend constexpr basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+                return it -= n;
+            }
+            friend constexpr difference_type operator-(const basic_iterator &left,
+                                                       const basic_iterator &right) noexcept {
+                return difference_type(left._index) - difference_type(right._index);
+            }
+            friend constexpr bool operator==(const basic_iterator &left, const basic_iterator &right) noexcept {
+                return left._index == right._index;
+            }
+            friend constexpr auto operator<=>(const basic_iterator &left, const basic_iterator &right) noexcept {
+                return left._index <=> right._index;
+            }
+        };
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+      private:
+        static constexpr size_type mask = ring_capacity - 1;
+        using index_type                = ::stack_vector::details::smallest_size_t<ring_capacity>;
+
+        index_type                                               _head = 0; // ring slot of the front
+        index_type                                               _size = 0;
+        ::stack_vector::details::inline_buffer<T, ring_capacity> _ring;
+
+        [[nodiscard]] constexpr pointer slot(size_type index) noexcept {
+            return _ring.store.data() + ((_head + index) & mask);
+        }
+        [[nodiscard]] constexpr const_pointer slot(size_type index) const noexcept {
+            return _ring.store.data() + ((_head + index) & mask);
+        }
+        // false when full, after throwing if stack_vector's error handling says so
+        constexpr bool has_room() const {
+            if (_size < ring_capacity) [[likely]]
+                return true;
+            ::stack_vector::details::report_full("stack_deque cannot allocate to insert elements");
+            return false;
+        }
+        constexpr bool has_elements(const char *err_msg) const {
+            if (_size) [[likely]]
+                return true;
+            if constexpr (::stack_vector::details::error_handler ==
+                          ::stack_vector::details::error_handling::_exception) {
+                throw std::domain_error(err_msg);
+            }
+            return false;
+        }
+        template <typename Other> constexpr void append_from(Other &&other) {
+            for (size_type i = 0; i < other.size(); i++) {
+                if constexpr (::std::is_rvalue_reference<Other &&>::value)
+                    ::std::construct_at(slot(i), ::std::move(other[i]));
+                else
+                    ::std::construct_at(slot(i), other[i]);
+                _size += 1;
+            }
+        }
+
+      public:
+        // constructor's
+        constexpr stack_deque() noexcept {
+        }
+        constexpr stack_deque(::std::initializer_list<T> init) {
+            for (const T &value : init)
+                push_back(value);
+        }
+        constexpr stack_deque(const stack_deque &other) {
+            append_from(other);
+        }
+        constexpr stack_deque(stack_deque &&other) noexcept(::std::is_nothrow_move_constructible<T>::value) {
+            append_from(::std::move(other));
+            other.clear();
+        }
+        constexpr stack_deque &operator=(const stack_deque &other) {
+            if (this != &other) {
+                clear();
+                append_from(other);
+            }
+            return *this;
+        }
+        constexpr stack_deque &operator=(stack_deque &&other) noexcept(::std::is_nothrow_move_constructible<T>::value) {
+            if (this != &other) {
+                clear();
+                append_from(::std::move(other));
+                other.clear();
+            }
+            return *this;
+        }
+        constexpr ~stack_deque() requires ::std::is_trivially_destructible<T>::value = default;
+        constexpr ~stack_deque() {
+            clear();
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return !_size;
+        }
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size == ring_capacity;
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _size;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return ring_capacity;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return ring_capacity;
+        }
+
+        // element access
+        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept {
+            assert(pos < size());
+            return *slot(pos);
+        }
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept {
+            assert(pos < size());
+            return *slot(pos);
+        }
+        [[nodiscard]] constexpr reference at(size_type pos) {
+            if (pos >= size())
+                throw ::std::out_of_range("stack_deque index out of range");
+            return *slot(pos);
+        }
+        [[nodiscard]] constexpr const_reference at(size_type pos) const {
+            if (pos >= size())
+                throw ::std::out_of_range("stack_deque index out of range");
+            return *slot(pos);
+        }
+        [[nodiscard]] constexpr reference front() noexcept {
+            assert(!empty());
+            return *slot(0);
+        }
+        [[nodiscard]] constexpr const_reference front() const noexcept {
+            assert(!empty());
+            return *slot(0);
+        }
+        [[nodiscard]] constexpr reference back() noexcept {
+            assert(!empty());
+            return *slot(_size - 1);
+        }
+        [[nodiscard]] constexpr const_reference back() const noexcept {
+            assert(!empty());
+            return *slot(_size - 1);
+        }
+
+        // the elements as (at most) two contiguous runs, front first, the second is empty unless they wrap
+        [[nodiscard]] constexpr ::std::pair<::std::span<T>, ::std::span<T>> as_spans() noexcept {
+            const size_type first_count = ::std::min<size_type>(_size, ring_capacity - _head);
+            return {::std::span<T>(_ring.store.data() + _head, first_count),
+                    ::std::span<T>(_ring.store.data(), _size - first_count)};
+        }
+        [[nodiscard]] constexpr ::std::pair<::std::span<const T>, ::std::span<const T>> as_spans() const noexcept {
+            const size_type first_count = ::std::min<size_type>(_size, ring_capacity - _head);
+            return {::std::span<const T>(_ring.store.data() + _head, first_count),
+                    ::std::span<const T>(_ring.store.data(), _size - first_count)};
+        }
+
+        // iterators
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return iterator(this, 0);
+        }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return const_iterator(this, 0);
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return const_iterator(this, 0);
+        }
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return iterator(this, _size);
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return const_iterator(this, _size);
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return const_iterator(this, _size);
+        }
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        // modifiers, pushing onto a full deque follows stack_vector's error handling and leaves it as is
+        template <class... Args> constexpr bool emplace_back(Args &&...args) {
+            if (!has_room())
+                return false;
+            ::std::construct_at(slot(_size), ::std::forward<Args>(args)...);
+            _size += 1;
+            return true;
+        }
+        template <class... Args> constexpr bool emplace_front(Args &&...args) {
+            if (!has_room())
+                return false;
+            const index_type head = index_type((_head - 1) & mask);
+            ::std::construct_at(_ring.store.data() + head, ::std::forward<Args>(args)...);
+            _head = head;
+            _size += 1;
+            return true;
+        }
+        constexpr bool push_back(const T &value) {
+            return emplace_back(value);
+        }
+        constexpr bool push_back(T &&value) {
+            return emplace_back(::std::move(value));
+        }
+        constexpr bool push_front(const T &value) {
+            return emplace_front(value);
+        }
+        constexpr bool push_front(T &&value) {
+            return emplace_front(::std::move(value));
+        }
+        constexpr void pop_back() {
+            if (!has_elements("stack_deque cannot pop_back when empty"))
+                return;
+            _size -= 1;
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::stack_vector::details::destroy_at(slot(_size));
+        }
+        constexpr void pop_front() {
+            if (!has_elements("stack_deque cannot pop_front when empty"))
+                return;
+            if constexpr (!::std::is_trivially_destructible<T>::value)
+                ::stack_vector::details::destroy_at(slot(0));
+            _head = index_type((_head + 1) & mask);
+            _size -= 1;
+        }
+        // drops the count oldest elements at once (all of them if there are fewer), for sliding windows
+        constexpr void pop_front_n(size_type count) noexcept {
+            count = ::std::min<size_type>(count, _size);
+            if constexpr (!::std::is_trivially_destructible<T>::value) {
+                for (size_type i = 0; i < count; i++)
+                    ::stack_vector::details::destroy_at(slot(i));
+            }
+            _head = index_type((_head + count) & mask);
+            _size = index_type(_size - count);
+        }
+        constexpr void clear() noexcept {
+            pop_front_n(_size);
+            _head = 0;
+        }
+        constexpr void swap(stack_deque &other) noexcept(::std::is_nothrow_move_constructible<T>::value) {
+            stack_deque tmp(::std::move(other));
+            other = ::std::move(*this);
+            *this = ::std::move(tmp);
+        }
+    };
+} // namespace stack_vector
+
+// non-members
+template <class T, size_t N0, size_t N1>
+[[nodiscard]] constexpr bool operator==(const stack_vector::stack_deque<T, N0> &left,
+                                        const stack_vector::stack_deque<T, N1> &right) {
+    return ::std::equal(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template <class T, size_t N0, size_t N1>
+[[nodiscard]] constexpr auto operator<=>(const stack_vector::stack_deque<T, N0> &left,
+                                         const stack_vector::stack_deque<T, N1> &right) {
+    return ::std::lexicographical_compare_three_way(left.begin(), left.end(), right.begin(), right.end());
+}
@@ -0,0 +1,419 @@
+#pragma once
+#include <tuple>
+#include <utility>
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// every column of a stack_soa starts on this boundary, enough for aligned loads of the widest vectors
+// (and a cache line)
+#ifndef STACK_VECTOR_SOA_ALIGNMENT
+#define STACK_VECTOR_SOA_ALIGNMENT 64
+#endif
+
+namespace stack_vector {
+    namespace details {
+        template <typename T, size_t N> struct alignas(STACK_VECTOR_SOA_ALIGNMENT) soa_column {
+            ::stack_vector::details::inline_buffer<T, N> elements;
+        };
+    } // namespace details
+
+    // up to N rows of Ts... stored column by column, each column a contiguous, aligned array of one field
+    // and one size counter for all of them. Rows are tuples of references.
+    template <size_t N, typename... Ts> struct stack_soa {
+        static_assert(N > 0, "a stack_soa<N,Ts...> must have an N > 0");
+        static_assert(sizeof...(Ts) > 0, "a stack_soa<N,Ts...> needs at least one column");
+
+      public:
+        using value_type      = ::std::tuple<Ts...>;
+        using reference       = ::std::tuple<Ts &...>;
+        using const_reference = ::std::tuple<const Ts &...>;
+        using size_type       = ::std::size_t;
+        using difference_type = ::std::ptrdiff_t;
+
+        static constexpr size_type column_count = sizeof...(Ts);
+        template <size_t I> using column_type   = ::std::tuple_element_t<I, value_type>;
+
+        // walks the rows, dereferences to a tuple of references (structured bindings work on it)
+        template <bool Const> class basic_iterator {
+            friend struct stack_soa;
+            friend class basic_iterator<!Const>;
+            using soa_pointer = typename ::std::conditional<Const, const stack_soa *, stack_soa *>::type;
+
+            soa_pointer _soa   = nullptr;
+            size_type   _index = 0;
+
+            constexpr basic_iterator(soa_pointer soa, size_type index) noexcept : _soa(soa), _index(index) {
+            }
+
+          public:
+            using iterator_category = ::std::random_access_iterator_tag;
+            using value_type        = typename stack_soa::value_type;
+            using difference_type   = ::std::ptrdiff_t;
+            using reference =
+                typename ::std::conditional<Const, stack_soa::const_reference, stack_soa::reference>::type;
+
+            constexpr basic_iterator() noexcept = default;
+            template <bool OtherConst>
+            constexpr basic_iterator(const basic_iterator<OtherConst> &other) noexcept
+                requires(Const && !OtherConst)
+                : _soa(other._soa), _index(other._index) {
+            }
+
+            constexpr reference operator*() const noexcept {
+                return (*_soa)[_index];
+            }
+            constexpr reference operator[](difference_type n) const noexcept {
+                return (*_soa)[size_type(difference_type(_index) + n)];
+            }
+            constexpr size_type index() const noexcept {
+                return _index;
+            }
+
+            constexpr basic_iterator &operator++() noexcept {
+                ++_index;
+                return *this;
+            }
+            constexpr basic_iterator operator++(int) noexcept {
+                basic_iterator ret = *this;
+                ++_index;
+                return ret;
+            }
+            constexpr basic_iterator &operator--() noexcept {
+                --_index;
+                return *this;
+            }
+            constexpr basic_iterator operator--(int) noexcept {
+                basic_iterator ret = *this;
+                --_index;
+                return ret;
+            }
+            constexpr basic_iterator &operator+=(difference_type n) noexcept {
+                _index = size_type(difference_type(_index) + n);
+                return *this;
+            }
+            constexpr basic_iterator &operator-=(difference_type n) noexcept {
+                return *this += -n;
+            }
+            friend constexpr basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+                return it += n;
+            }
+            friend constexpr basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+                return it -= n;
+            }
+            friend constexpr difference_type operator-(const basic_iterator &left,
+                                                       const basic_iterator &right) noexcept {
+                return difference_type(left._index) - difference_type(right._index);
+            }
+            friend constexpr bool operator==(const basic_iterator &left,
+                                             const basic_iterator &right) noexcept {
+                return left._index == right._index;
+            }
+            friend constexpr auto operator<=>(const basic_iterator &left,
+                                              const basic_iterator &right) noexcept {
+                return left._index <=> right._index;
+            }
+        };
+        using iterator       = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+      private:
+        using indices = ::std::index_sequence_for<Ts...>;
+
+        ::stack_vector::details::smallest_size_t<N>                  _size = 0;
+        ::std::tuple<::stack_vector::details::soa_column<Ts, N>...> _columns;
+
+        template <size_t I> [[nodiscard]] constexpr column_type<I> *column_data() noexcept {
+            return ::std::get<I>(_columns).elements.store.data();
+        }
+        template <size_t I> [[nodiscard]] constexpr const column_type<I> *column_data() const noexcept {
+            return ::std::get<I>(_columns).elements.store.data();
+        }
+        // fn(std::integral_constant<size_t, I>) for every column I
+        template <typename Fn> constexpr void for_each_column(Fn &&fn) {
+            [&]<size_t... Is>(::std::index_sequence<Is...>) {
+                (fn(::std::integral_constant<size_t, Is>{}), ...);
+            }(indices{});
+        }
+        template <size_t... Is>
+        constexpr reference row(size_type pos, ::std::index_sequence<Is...>) noexcept {
+            return reference(column_data<Is>()[pos]...);
+        }
+        template <size_t... Is>
+        constexpr const_reference row(size_type pos, ::std::index_sequence<Is...>) const noexcept {
+            return const_reference(column_data<Is>()[pos]...);
+        }
+        // like stack_vector, in a constant expression every column's store is value initialized up front
+        constexpr void start_columns() noexcept {
+            for_each_column([&](auto I) {
+                ::stack_vector::details::start_storage(::std::get<I>(_columns).elements.store);
+            });
+        }
+        // build(I) for every column I in order, if one throws undo(I) runs for the columns already built
+        template <typename Build, typename Undo> constexpr void build_columns(Build &&build, Undo &&undo) {
+            size_type built = 0;
+            try {
+                for_each_column([&](auto I) {
+                    build(I);
+                    built += 1;
+                });
+            } catch (...) {
+                for_each_column([&](auto I) {
+                    if (I < built)
+                        undo(I);
+                });
+                throw;
+            }
+        }
+        constexpr void destroy_rows(size_type first, size_type last) noexcept {
+            for_each_column([&](auto I) {
+                ::stack_vector::details::destroy(column_data<I>() + first, column_data<I>() + last);
+            });
+        }
+        constexpr void copy_rows(const stack_soa &other) {
+            build_columns(
+                [&](auto I) {
+                    ::stack_vector::details::uninitialized_copy_n(other.template column_data<I>(), other.size(), column_data<I>());
+                },
+                [&](auto I) {
+                    ::stack_vector::details::destroy(column_data<I>(), column_data<I>() + other.size());
+                });
+        }
+        constexpr void move_rows(stack_soa &other) {
+            build_columns(
+                [&](auto I) {
+                    ::stack_vector::details::uninitialized_move_n(other.template column_data<I>(), other.size(), column_data<I>());
+                },
+                [&](auto I) {
+                    ::stack_vector::details::destroy(column_data<I>(), column_data<I>() + other.size());
+                });
+        }
+        // rows [pos + count, size) slide down to pos in every column, the count rows left at the end are
+        // destroyed
+        constexpr void close_gap(size_type pos, size_type count) {
+            for_each_column([&](auto I) {
+                auto *col = column_data<I>();
+                ::std::move(col + pos + count, col + size(), col + pos);
+                ::stack_vector::details::destroy(col + size() - count, col + size());
+            });
+        }
+        constexpr void move_last_to(size_type pos) {
+            for_each_column([&](auto I) {
+                auto *col = column_data<I>();
+                col[pos]  = ::std::move(col[size() - 1]);
+                ::stack_vector::details::destroy_at(col + size() - 1);
+            });
+        }
+
+      public:
+        // constructor's
+        constexpr stack_soa() noexcept {
+            start_columns();
+        }
+        constexpr stack_soa(const stack_soa &other) {
+            start_columns();
+            copy_rows(other);
+            _size = other._size;
+        }
+        constexpr stack_soa(stack_soa &&other) noexcept(
+            (::std::is_nothrow_move_constructible<Ts>::value && ...)) {
+            start_columns();
+            move_rows(other);
+            _size = other._size;
+            other.clear();
+        }
+        constexpr stack_soa &operator=(const stack_soa &other) {
+            if (this != &other) {
+                clear();
+                copy_rows(other);
+                _size = other._size;
+            }
+            return *this;
+        }
+        constexpr stack_soa &operator=(stack_soa &&other) noexcept(
+            (::std::is_nothrow_move_constructible<Ts>::value && ...)) {
+            if (this != &other) {
+                clear();
+                move_rows(other);
+                _size = other._size;
+                other.clear();
+            }
+            return *this;
+        }
+        constexpr ~stack_soa() {
+            clear();
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return !_size;
+        }
+        [[nodiscard]] constexpr bool full() const noexcept {
+            return _size == N;
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _size;
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return N;
+        }
+
+        // columns, each one contiguous and aligned to STACK_VECTOR_SOA_ALIGNMENT
+        template <size_t I> [[nodiscard]] constexpr ::std::span<column_type<I>> column() noexcept {
+            return ::std::span<column_type<I>>(column_data<I>(), size());
+        }
+        template <size_t I>
+        [[nodiscard]] constexpr ::std::span<const column_type<I>> column() const noexcept {
+            return ::std::span<const column_type<I>>(column_data<I>(), size());
+        }
+
+        // rows
+        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept {
+            assert(pos < size());
+            return row(pos, indices{});
+        }
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept {
+            assert(pos < size());
+            return row(pos, indices{});
+        }
+        [[nodiscard]] constexpr reference at(size_type pos) {
+            if (pos >= size())
+                throw ::std::out_of_range("stack_soa index out of range");
+            return row(pos, indices{});
+        }
+        [[nodiscard]] constexpr const_reference at(size_type pos) const {
+            if (pos >= size())
+                throw ::std::out_of_range("stack_soa index out of range");
+            return row(pos, indices{});
+        }
+        [[nodiscard]] constexpr reference front() noexcept {
+            return row(0, indices{});
+        }
+        [[nodiscard]] constexpr const_reference front() const noexcept {
+            return row(0, indices{});
+        }
+        [[nodiscard]] constexpr reference back() noexcept {
+            return row(size() - 1, indices{});
+        }
+        [[nodiscard]] constexpr const_reference back() const noexcept {
+            return row(size() - 1, indices{});
+        }
+
+        // iterators
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return iterator(this, 0);
+        }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return const_iterator(this, 0);
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return const_iterator(this, 0);
+        }
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return iterator(this, size());
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return const_iterator(this, size());
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return const_iterator(this, size());
+        }
+
+        // modifiers, a row goes in whole or not at all. Adding to a full stack_soa follows stack_vector's
+        // error handling and returns false.
+        template <class... Args>
+        requires(sizeof...(Args) == sizeof...(Ts))
+        constexpr bool emplace_back(Args &&...args) {
+            if (full()) [[unlikely]] {
+                ::stack_vector::details::report_full("stack_soa cannot allocate to insert elements");
+                return false;
+            }
+            // a throwing column destroys the fields already built, the size only moves once the row is whole
+            auto fields = ::std::forward_as_tuple(::std::forward<Args>(args)...);
+            build_columns(
+                [&](auto I) {
+                    ::std::construct_at(column_data<I>() + size(), ::std::get<I>(::std::move(fields)));
+                },
+                [&](auto I) { ::stack_vector::details::destroy_at(column_data<I>() + size()); });
+            _size += 1;
+            return true;
+        }
+        constexpr bool push_back(const value_type &value) {
+            return ::std::apply([&](const auto &...fields) { return emplace_back(fields...); }, value);
+        }
+        constexpr bool push_back(value_type &&value) {
+            return ::std::apply([&](auto &...fields) { return emplace_back(::std::move(fields)...); }, value);
+        }
+        constexpr void pop_back() {
+            if (empty()) {
+                if constexpr (::stack_vector::details::error_handler ==
+                              ::stack_vector::details::error_handling::_exception) {
+                    throw std::domain_error("stack_soa cannot pop_back when empty");
+                }
+                return;
+            }
+            destroy_rows(size() - 1, size());
+            _size -= 1;
+        }
+        // removes row pos, the rows after it move up one in every column (order is kept)
+        constexpr iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+        constexpr iterator erase(const_iterator first, const_iterator last) {
+            const size_type count = size_type(last - first);
+            if (count) {
+                close_gap(first.index(), count);
+                _size -= count;
+            }
+            return iterator(this, first.index());
+        }
+        // removes row pos in O(1) by moving the last row into it, order isn't kept
+        constexpr iterator
+        swap_erase(const_iterator pos) noexcept((::std::is_nothrow_move_assignable<Ts>::value && ...)) {
+            assert(pos >= cbegin() && pos < cend() && "swap_erase iterator is out of bounds of the stack_soa");
+            if (pos.index() + 1 != size())
+                move_last_to(pos.index());
+            else
+                destroy_rows(pos.index(), pos.index() + 1);
+            _size -= 1;
+            return iterator(this, pos.index());
+        }
+        constexpr void clear() noexcept {
+            destroy_rows(0, size());
+            _size = 0;
+        }
+        constexpr void swap(stack_soa &other) {
+            stack_soa tmp(::std::move(other));
+            other = ::std::move(*this);
+            *this = ::std::move(tmp);
+        }
+    };
+} // namespace stack_vector
@@ -0,0 +1,346 @@
+#pragma once
+#include <charconv>
+#include <functional>
+#include <string_view>
+#if __has_include(<format>)
+#include <format>
+#endif
+#include "stack_vector.h"
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+namespace stack_vector {
+    // up to N chars and a null terminator, in a stack_vector<char, N + 1>, trivially copyable while the
+    // stack_vector underneath is (see STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES)
+    template <size_t N> struct stack_string {
+      public:
+        using traits_type            = ::std::char_traits<char>;
+        using value_type             = char;
+        using size_type              = ::std::size_t;
+        using difference_type        = ::std::ptrdiff_t;
+        using reference              = char &;
+        using const_reference        = const char &;
+        using pointer                = char *;
+        using const_pointer          = const char *;
+        using iterator               = pointer;
+        using const_iterator         = const_pointer;
+        using reverse_iterator       = ::std::reverse_iterator<iterator>;
+        using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type npos = ::std::string_view::npos;
+
+      private:
+        using chars_type = ::stack_vector::stack_vector<char, N + 1>;
+        // a trivially copyable stack_vector copies its spare slots too, a larger one only its elements and
+        // the terminator has to be written again
+        static constexpr bool copies_terminator = ::std::is_trivially_copyable<chars_type>::value;
+
+        // the terminator lives in the spare slot, so the chars are the stack_vector's elements
+        chars_type _chars;
+
+        constexpr void terminate() noexcept {
+            _chars.data()[_chars.size()] = '\0';
+        }
+        // how many of count more chars can be taken, following stack_vector's error handling
+        constexpr size_type fit(size_type count) const {
+            if (count <= N - size()) [[likely]]
+                return count;
+            // counted against the stack_vector<char, N + 1> the chars live in
+            ::stack_vector::telemetry::details::overflowed<char, N + 1>();
+            ::stack_vector::details::report_full("stack_string cannot allocate to insert elements");
+            if constexpr (::stack_vector::details::error_handler ==
+                          ::stack_vector::details::error_handling::_saturate) {
+                return N - size();
+            } else {
+                return 0;
+            }
+        }
+
+      public:
+        // constructor's
+        constexpr stack_string() noexcept {
+            terminate();
+        }
+        constexpr stack_string(::std::string_view str) {
+            terminate();
+            append(str);
+        }
+        constexpr stack_string(const char *str) : stack_string(::std::string_view(str)) {
+        }
+        constexpr stack_string(size_type count, char ch) {
+            terminate();
+            append(count, ch);
+        }
+        constexpr stack_string(const stack_string &) noexcept requires copies_terminator = default;
+        constexpr stack_string(const stack_string &other) noexcept : _chars(other._chars) {
+            terminate();
+        }
+        constexpr stack_string(stack_string &&) noexcept requires copies_terminator = default;
+        constexpr stack_string(stack_string &&other) noexcept : _chars(::std::move(other._chars)) {
+            terminate();
+        }
+
+        // operator ='s
+        constexpr stack_string &operator=(const stack_string &) noexcept requires copies_terminator = default;
+        constexpr stack_string &operator=(const stack_string &other) noexcept {
+            _chars = other._chars;
+            terminate();
+            return *this;
+        }
+        constexpr stack_string &operator=(stack_string &&) noexcept requires copies_terminator = default;
+        constexpr stack_string &operator=(stack_string &&other) noexcept {
+            _chars = ::std::move(other._chars);
+            terminate();
+            return *this;
+        }
+
+        // capacity
+        [[nodiscard]] constexpr bool empty() const noexcept {
+            return _chars.empty();
+        }
+        [[nodiscard]] constexpr size_type size() const noexcept {
+            return _chars.size();
+        }
+        [[nodiscard]] constexpr size_type length() const noexcept {
+            return _chars.size();
+        }
+        [[nodiscard]] constexpr size_type capacity() const noexcept {
+            return N;
+        }
+        [[nodiscard]] constexpr size_type max_size() const noexcept {
+            return N;
+        }
+
+        // element access, like std::string [size()] is the terminator
+        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept {
+            assert(pos <= size());
+            return _chars.data()[pos];
+        }
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept {
+            assert(pos <= size());
+            return _chars.data()[pos];
+        }
+        [[nodiscard]] constexpr reference front() noexcept {
+            return _chars.front();
+        }
+        [[nodiscard]] constexpr const_reference front() const noexcept {
+            return _chars.front();
+        }
+        [[nodiscard]] constexpr reference back() noexcept {
+            return _chars.back();
+        }
+        [[nodiscard]] constexpr const_reference back() const noexcept {
+            return _chars.back();
+        }
+        [[nodiscard]] constexpr pointer data() noexcept {
+            return _chars.data();
+        }
+        [[nodiscard]] constexpr const_pointer data() const noexcept {
+            return _chars.data();
+        }
+        [[nodiscard]] constexpr const_pointer c_str() const noexcept {
+            return _chars.data();
+        }
+        [[nodiscard]] constexpr ::std::string_view view() const noexcept {
+            return ::std::string_view(data(), size());
+        }
+        constexpr operator ::std::string_view() const noexcept {
+            return view();
+        }
+
+        // iterators
+        [[nodiscard]] constexpr iterator begin() noexcept {
+            return _chars.begin();
+        }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept {
+            return _chars.begin();
+        }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept {
+            return _chars.cbegin();
+        }
+        [[nodiscard]] constexpr iterator end() noexcept {
+            return _chars.end();
+        }
+        [[nodiscard]] constexpr const_iterator end() const noexcept {
+            return _chars.end();
+        }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept {
+            return _chars.cend();
+        }
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept {
+            return reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept {
+            return reverse_iterator(begin());
+        }
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        // modifiers
+        constexpr void clear() noexcept {
+            _chars.clear();
+            terminate();
+        }
+        constexpr void push_back(char ch) {
+            if (fit(1)) {
+                _chars.shove_back(ch);
+                terminate();
+            }
+        }
+        constexpr void pop_back() noexcept {
+            assert(!empty() && "stack_string cannot pop_back when empty");
+            if (!empty()) {
+                _chars.pop_back();
+                terminate();
+            }
+        }
+        constexpr stack_string &append(::std::string_view str) {
+            const size_type count = fit(str.size());
+            ::std::copy_n(str.data(), count, _chars.spare_capacity().data());
+            _chars.commit(count);
+            terminate();
+            return *this;
+        }
+        constexpr stack_string &append(size_type count, char ch) {
+            count = fit(count);
+            ::std::fill_n(_chars.spare_capacity().data(), count, ch);
+            _chars.commit(count);
+            terminate();
+            return *this;
+        }
+        constexpr stack_string &operator+=(::std::string_view str) {
+            return append(str);
+        }
+        constexpr stack_string &operator+=(char ch) {
+            push_back(ch);
+            return *this;
+        }
+        constexpr void resize(size_type count, char ch = '\0') {
+            if (count <= size()) {
+                _chars.resize(count);
+                terminate();
+            } else {
+                append(count - size(), ch);
+            }
+        }
+        // an integer or floating point value through std::to_chars, how much of it is kept past the capacity
+        // follows stack_vector's error handling like append, true if all of it was
+        template <typename Number> bool append_number(Number value) {
+            ::std::span<char> spare = _chars.spare_capacity();
+            auto [last, ec]         = ::std::to_chars(spare.data(), spare.data() + (spare.size() - 1), value);
+            if (ec == ::std::errc()) [[likely]] {
+                _chars.commit(size_type(last - spare.data()));
+                terminate();
+                return true;
+            }
+            // too long for the spare capacity (which may have been written over, terminator included), the
+            // shortest form of any arithmetic type fits in here
+            terminate();
+            char digits[128];
+            auto [digits_last, digits_ec] = ::std::to_chars(digits, digits + sizeof(digits), value);
+            if (digits_ec != ::std::errc())
+                return false;
+            const size_type wanted = size_type(digits_last - digits);
+            const size_type count  = fit(wanted);
+            ::std::copy_n(digits, count, spare.data());
+            _chars.commit(count);
+            terminate();
+            return count == wanted;
+        }
+#if defined(__cpp_lib_format)
+        // formats straight into the spare capacity, how much of output past the capacity is kept follows
+        // stack_vector's error handling like append, true if all of it was. Only built where <format> is
+        // available, which the GCC 12 toolchain of this tree's gates lacks, so that path is untested there
+        template <class... Args> bool format_append(::std::format_string<Args...> fmt, Args &&...args) {
+            ::std::span<char> spare  = _chars.spare_capacity();
+            const size_type   room   = spare.size() - 1;
+            auto              result = ::std::format_to_n(spare.data(), difference_type(room), fmt,
+                                                          ::std::forward<Args>(args)...);
+            const size_type   wanted = size_type(result.size);
+            // the output may have run over the terminator, put it back before fit can throw
+            terminate();
+            const size_type count = fit(wanted);
+            _chars.commit(count);
+            terminate();
+            return count == wanted;
+        }
+#endif
+
+        // searches
+        [[nodiscard]] constexpr size_type find(::std::string_view str, size_type pos = 0) const noexcept {
+            return view().find(str, pos);
+        }
+        [[nodiscard]] constexpr size_type find(char ch, size_type pos = 0) const noexcept {
+            return view().find(ch, pos);
+        }
+        [[nodiscard]] constexpr size_type rfind(::std::string_view str, size_type pos = npos) const noexcept {
+            return view().rfind(str, pos);
+        }
+        [[nodiscard]] constexpr size_type rfind(char ch, size_type pos = npos) const noexcept {
+            return view().rfind(ch, pos);
+        }
+        [[nodiscard]] constexpr bool contains(::std::string_view str) const noexcept {
+            return view().find(str) != npos;
+        }
+        [[nodiscard]] constexpr bool starts_with(::std::string_view str) const noexcept {
+            return view().starts_with(str);
+        }
+        [[nodiscard]] constexpr bool ends_with(::std::string_view str) const noexcept {
+            return view().ends_with(str);
+        }
+        [[nodiscard]] constexpr int compare(::std::string_view str) const noexcept {
+            return view().compare(str);
+        }
+
+        // comparisons, against anything viewable as a string_view
+        [[nodiscard]] friend constexpr bool operator==(const stack_string &left, ::std::string_view right) noexcept {
+            return left.view() == right;
+        }
+        [[nodiscard]] friend constexpr auto operator<=>(const stack_string &left, ::std::string_view right) noexcept {
+            return left.view() <=> right;
+        }
+        template <size_t N1>
+        [[nodiscard]] friend constexpr bool operator==(const stack_string &left, const stack_string<N1> &right) noexcept {
+            return left.view() == right.view();
+        }
+        template <size_t N1>
+        [[nodiscard]] friend constexpr auto operator<=>(const stack_string &left, const stack_string<N1> &right) noexcept {
+            return left.view() <=> right.view();
+        }
+    };
+} // namespace stack_vector
+
+namespace std {
+    // hashes as the equivalent string_view does, so either works for heterogeneous lookup
+    template <size_t N> struct hash<::stack_vector::stack_string<N>> {
+        [[nodiscard]] size_t operator()(const ::stack_vector::stack_string<N> &str) const noexcept {
+            return ::std::hash<::std::string_view>()(str.view());
+        }
+    };
+}; // namespace std
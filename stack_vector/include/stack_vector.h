@@ -1,13 +1,20 @@
 ﻿#pragma once
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <span>
 #include <stdexcept>
 
 #include <assert.h>
 
+#include "stack_vector_simd.h"
+#include "stack_vector_sort.h"
+#include "stack_vector_telemetry.h"
+
 /*
 The MIT License (MIT)
 
@@ -32,43 +39,330 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#if defined(_MSC_VER)
+#define STACK_VECTOR_FORCEINLINE __forceinline
+#else
+#define STACK_VECTOR_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+// stack_vectors of trivially copyable T's with at most this many bytes of storage are trivially copyable
+#ifndef STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES
+#define STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES 256
+#endif
+
+// the false sharing distance, counters written by different threads are kept this far apart
+#ifndef STACK_VECTOR_CACHE_LINE_SIZE
+#define STACK_VECTOR_CACHE_LINE_SIZE 64
+#endif
+
 namespace stack_vector {
+    // where the size counter lives relative to the element storage
+    enum class size_layout : uint8_t { _before, _after };
+
+    // T's that may be moved to a new address by copying their bytes and forgetting the original,
+    // specialize for your own handle types
+    template <typename T> struct is_trivially_relocatable : ::std::is_trivially_copyable<T> {};
+    template <typename T> struct is_trivially_relocatable<::std::unique_ptr<T>> : ::std::true_type {};
+    template <typename T>
+    constexpr bool is_trivially_relocatable_v = ::stack_vector::is_trivially_relocatable<T>::value;
+
     // for some detail trickery
     // see: https://github.com/tcbrindle/span/blob/master/include/tcb/span.hpp
     namespace details {
+        // trivial destructors are skipped, in a constant expression they would end the element's lifetime
         template <typename _Ty> constexpr void destroy_at(_Ty *const ptr) {
-            ptr->~_Ty();
+            if constexpr (!::std::is_trivially_destructible<_Ty>::value)
+                ptr->~_Ty();
         }
         template <typename It1> constexpr void destroy(It1 first, It1 last) {
             for (; first != last; ++first)
                 ::stack_vector::details::destroy_at(::std::addressof(*first));
         }
 
-        template <typename It1, typename It2> constexpr It1 uninitialized_copy(It1 I, It1 E, It2 Dest) {
+        // the std::uninitialized_ algorithms aren't constexpr, in a constant expression each element is built
+        // with construct_at instead
+        template <typename It1, typename It2> constexpr It2 uninitialized_copy(It1 I, It1 E, It2 Dest) {
+            if (::std::is_constant_evaluated()) {
+                for (; I != E; ++I, (void)++Dest)
+                    ::std::construct_at(::std::addressof(*Dest), *I);
+                return Dest;
+            }
             return ::std::uninitialized_copy(I, E, Dest);
         }
-        template <typename It1, typename It2> constexpr It1 uninitialized_copy_n(It1 I, size_t C, It2 Dest) {
+        template <typename It1, typename It2> constexpr It2 uninitialized_copy_n(It1 I, size_t C, It2 Dest) {
+            if (::std::is_constant_evaluated()) {
+                for (; C; --C, (void)++I, (void)++Dest)
+                    ::std::construct_at(::std::addressof(*Dest), *I);
+                return Dest;
+            }
             return ::std::uninitialized_copy_n(I, C, Dest);
         }
-        template <typename It1, typename It2> constexpr It1 uninitialized_move(It1 I, It1 E, It2 Dest) {
-            return ::std::uninitialized_copy(::std::make_move_iterator(I), ::std::make_move_iterator(E),
-                                             Dest);
+        template <typename It1, typename It2> constexpr It2 uninitialized_move(It1 I, It1 E, It2 Dest) {
+            return ::stack_vector::details::uninitialized_copy(::std::make_move_iterator(I),
+                                                               ::std::make_move_iterator(E), Dest);
         }
-        template <typename It1, typename It2> constexpr It1 uninitialized_move_n(It1 I, size_t C, It2 Dest) {
-            return ::std::uninitialized_copy_n(::std::make_move_iterator(I), C, Dest);
+        template <typename It1, typename It2> constexpr It2 uninitialized_move_n(It1 I, size_t C, It2 Dest) {
+            return ::stack_vector::details::uninitialized_copy_n(::std::make_move_iterator(I), C, Dest);
         }
-        template <typename It1, typename Val1> constexpr void uninitialized_fill(It1 I, It1 E, Val1 Dest) {
+        template <typename It1, typename Val1>
+        constexpr void uninitialized_fill(It1 I, It1 E, const Val1 &Dest) {
+            if (::std::is_constant_evaluated()) {
+                for (; I != E; ++I)
+                    ::std::construct_at(::std::addressof(*I), Dest);
+                return;
+            }
             ::std::uninitialized_fill(I, E, Dest);
         }
-        template <typename It1, typename Val1> constexpr void uninitialized_fill_n(It1 I, size_t C, Val1 V) {
+        template <typename It1, typename Val1>
+        constexpr void uninitialized_fill_n(It1 I, size_t C, const Val1 &V) {
+            if (::std::is_constant_evaluated()) {
+                for (; C; --C, (void)++I)
+                    ::std::construct_at(::std::addressof(*I), V);
+                return;
+            }
             ::std::uninitialized_fill_n(I, C, V);
         }
+        template <typename It1> constexpr void uninitialized_value_construct(It1 I, It1 E) {
+            if (::std::is_constant_evaluated()) {
+                for (; I != E; ++I)
+                    ::std::construct_at(::std::addressof(*I));
+                return;
+            }
+            ::std::uninitialized_value_construct(I, E);
+        }
+        // a constant expression can't hold indeterminate values, there they're value initialized
+        template <typename It1> constexpr void uninitialized_default_construct(It1 I, It1 E) {
+            if (::std::is_constant_evaluated()) {
+                ::stack_vector::details::uninitialized_value_construct(I, E);
+                return;
+            }
+            ::std::uninitialized_default_construct(I, E);
+        }
+
+        // larger stack_vectors copy, move and swap only their live elements instead of their whole storage
+        template <typename T, size_t N>
+        constexpr bool is_trivially_copyable_storage =
+            ::std::is_trivially_copyable<T>::value && (sizeof(T) * N) <= STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES;
+
+        template <typename T> constexpr void copy_trivial_n(const T *first, size_t count, T *dest) {
+            if (::std::is_constant_evaluated()) {
+                ::std::copy_n(first, count, dest);
+            } else if (count) {
+                ::std::memcpy((void *)dest, (const void *)first, count * sizeof(T));
+            }
+        }
+        template <typename T> constexpr void swap_trivial_n(T *left, T *right, size_t count) {
+            if (::std::is_constant_evaluated()) {
+                ::std::swap_ranges(left, left + count, right);
+                return;
+            }
+            // swap through a small buffer, a cache line at a time
+            unsigned char *left_bytes  = (unsigned char *)left;
+            unsigned char *right_bytes = (unsigned char *)right;
+            size_t         byte_count  = count * sizeof(T);
+            unsigned char  tmp[64];
+            // fixed size copies are inlined, only the remainder goes through a variable length memcpy
+            for (; byte_count >= sizeof(tmp); byte_count -= sizeof(tmp)) {
+                ::std::memcpy(tmp, left_bytes, sizeof(tmp));
+                ::std::memcpy(left_bytes, right_bytes, sizeof(tmp));
+                ::std::memcpy(right_bytes, tmp, sizeof(tmp));
+                left_bytes += sizeof(tmp);
+                right_bytes += sizeof(tmp);
+            }
+            if (byte_count) {
+                ::std::memcpy(tmp, left_bytes, byte_count);
+                ::std::memcpy(left_bytes, right_bytes, byte_count);
+                ::std::memcpy(right_bytes, tmp, byte_count);
+            }
+        }
+
+        // moves count T's from first to (possibly overlapping) dest, the originals are left destroyed
+        template <typename T> constexpr void relocate_n(T *first, size_t count, T *dest) {
+            if (first == dest || !count)
+                return;
+            if (::std::is_constant_evaluated()) {
+                if (dest < first) {
+                    for (size_t i = 0; i < count; i++) {
+                        ::std::construct_at(dest + i, ::std::move(first[i]));
+                        ::stack_vector::details::destroy_at(first + i);
+                    }
+                } else {
+                    for (size_t i = count; i > 0; i--) {
+                        ::std::construct_at(dest + (i - 1), ::std::move(first[i - 1]));
+                        ::stack_vector::details::destroy_at(first + (i - 1));
+                    }
+                }
+            } else {
+                ::std::memmove((void *)dest, (const void *)first, count * sizeof(T));
+            }
+        }
+
+        // relocate_n for ranges in different objects, which can't overlap (and can't be ordered in a constant
+        // expression)
+        template <typename T> constexpr void relocate_disjoint_n(T *first, size_t count, T *dest) {
+            if (::std::is_constant_evaluated()) {
+                for (size_t i = 0; i < count; i++) {
+                    ::std::construct_at(dest + i, ::std::move(first[i]));
+                    ::stack_vector::details::destroy_at(first + i);
+                }
+            } else if (count) {
+                ::std::memcpy((void *)dest, (const void *)first, count * sizeof(T));
+            }
+        }
+
+        // slide [pos, last) up by count in one pass from the back, leaving [pos, pos + count)
+        // uninitialized and the tail ending at last + count
+        template <typename T> constexpr void open_gap(T *pos, T *last, size_t count) {
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::relocate_n(pos, size_t(last - pos), pos + count);
+            } else {
+                // the tail's last count elements land past the end, the rest on moved from elements
+                const size_t moved = ::std::min<size_t>(count, size_t(last - pos));
+                ::stack_vector::details::uninitialized_move(last - moved, last, last - moved + count);
+                ::std::move_backward(pos, last - moved, last);
+                ::stack_vector::details::destroy(pos, pos + moved);
+            }
+        }
+        // the reverse, slide [pos + count, last) back down over the uninitialized [pos, pos + count)
+        template <typename T> constexpr void close_gap(T *pos, T *last, size_t count) {
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::relocate_n(pos + count, size_t(last - pos) - count, pos);
+            } else {
+                T *const     new_last = last - count;
+                const size_t moved    = ::std::min<size_t>(count, size_t(new_last - pos));
+                ::stack_vector::details::uninitialized_move(pos + count, pos + count + moved, pos);
+                ::std::move(pos + count + moved, last, pos + moved);
+                ::stack_vector::details::destroy(::std::max(new_last, pos + count), last);
+            }
+        }
+
+        // std::erase and std::erase_if for the contiguous containers, arithmetic T's go through the
+        // vectorized kernels
+        template <class C, class U> constexpr typename C::size_type erase_value(C &c, const U &value) {
+            using T = typename C::value_type;
+            if constexpr (::stack_vector::simd::kernel_comparable<T, U>) {
+                T needle{};
+                if (!::stack_vector::simd::narrow(value, needle))
+                    return 0;
+                const size_t kept = ::stack_vector::simd::remove(c.data(), c.size(), needle);
+                const size_t r    = c.size() - kept;
+                c.erase(c.begin() + kept, c.end());
+                return r;
+            } else {
+                auto it = ::std::remove(c.begin(), c.end(), value);
+                auto r  = ::std::distance(it, c.end());
+                c.erase(it, c.end());
+                return r;
+            }
+        }
+        template <class C, class Pred> constexpr typename C::size_type erase_value_if(C &c, Pred pred) {
+            if constexpr (::stack_vector::simd::kernel_type<typename C::value_type>) {
+                // no branch on the predicate, it can't be predicted on a mixed list
+                const size_t kept = ::stack_vector::simd::remove_if(c.data(), c.size(), pred);
+                const size_t r    = c.size() - kept;
+                c.erase(c.begin() + kept, c.end());
+                return r;
+            } else {
+                auto it = ::std::remove_if(c.begin(), c.end(), pred);
+                auto r  = ::std::distance(it, c.end());
+                c.erase(it, c.end());
+                return r;
+            }
+        }
 
         enum class error_handling : uint8_t { _noop, _saturate, _exception, _error_code };
         constexpr const error_handling error_handler = error_handling::_noop;
+
+        // every container reports running out of room through here, it throws std::bad_alloc when
+        // error_handler is _exception and does nothing otherwise. A template, as a constexpr function that
+        // can only throw is ill formed
+        template <typename CharT> constexpr void report_full([[maybe_unused]] const CharT *err_msg) {
+            if constexpr (error_handler == error_handling::_exception) {
+#if !defined(_MSC_VER)
+                throw std::bad_alloc();
+#else
+                throw std::bad_alloc(err_msg);
+#endif
+            }
+        }
+
+        // the smallest unsigned type able to count [0, N]
+        template <size_t N>
+        using smallest_size_t = typename ::std::conditional<
+            N <= UINT8_MAX, uint8_t,
+            typename ::std::conditional<
+                N <= UINT16_MAX, uint16_t,
+                typename ::std::conditional<N <= UINT32_MAX, uint32_t, uint64_t>::type>::type>::type;
+
+        // N uninitialized T's, the same union stack_vector_storage keeps its elements in
+        template <typename T, size_t N> union inline_buffer {
+            char             a_byte = 0;
+            T                a_t;
+            std::array<T, N> store;
+
+            constexpr inline_buffer() noexcept {
+            }
+            constexpr ~inline_buffer() requires ::std::is_trivially_destructible<T>::value = default;
+            constexpr ~inline_buffer() {
+            }
+        };
+
+        // a constant expression (a constexpr or constinit variable, a template argument) can't hold
+        // uninitialized elements, there the whole store of trivial T's is value initialized up front. At
+        // runtime it's left alone.
+        template <typename T, size_t N> constexpr void start_storage(::std::array<T, N> &store) noexcept {
+            if constexpr (::std::is_trivially_default_constructible<T>::value) {
+                if (::std::is_constant_evaluated())
+                    ::std::construct_at(::std::addressof(store));
+            }
+        }
+
+        // the size counter, when telemetry is on one that records how large it gets
+        template <typename T, size_t N>
+        using size_counter = typename ::std::conditional<
+            ::stack_vector::telemetry::enabled,
+            ::stack_vector::telemetry::details::tracked_size<smallest_size_t<N>, T, N>, smallest_size_t<N>>::type;
+
+        // the size counter and the (possibly uninitialized) elements, in the order given by Layout
+        template <typename T, size_t N, size_layout Layout> struct stack_vector_storage;
+
+        template <typename T, size_t N> struct stack_vector_storage<T, N, size_layout::_before> {
+            size_counter<T, N> _size{};
+            // Avoid construction of T's if T has a constructor
+            union {
+                char             a_byte;
+                T                a_t;
+                std::array<T, N> store;
+            };
+
+            constexpr stack_vector_storage() noexcept {
+                ::stack_vector::details::start_storage(store);
+            }
+            constexpr ~stack_vector_storage() requires ::std::is_trivially_destructible<T>::value = default;
+            constexpr ~stack_vector_storage() {
+            }
+        };
+
+        template <typename T, size_t N> struct stack_vector_storage<T, N, size_layout::_after> {
+            // Avoid construction of T's if T has a constructor
+            union {
+                char             a_byte;
+                T                a_t;
+                std::array<T, N> store;
+            };
+            size_counter<T, N> _size{};
+
+            constexpr stack_vector_storage() noexcept {
+                ::stack_vector::details::start_storage(store);
+            }
+            constexpr ~stack_vector_storage() requires ::std::is_trivially_destructible<T>::value = default;
+            constexpr ~stack_vector_storage() {
+            }
+        };
     }; // namespace details
 
-    template <typename T, size_t N> struct stack_vector {
+    template <typename T, size_t N, size_layout Layout = size_layout::_before>
+    struct stack_vector : public ::stack_vector::details::stack_vector_storage<T, N, Layout> {
         static_assert(N > 0, "a stack_vector<T,N> must have an N > 0");
 
       public:
@@ -86,18 +380,20 @@ namespace stack_vector {
         using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
 
       private:
-        using array_type = ::std::array<T, N>;
-        using union_type = ::std::aligned_union<1, array_type>;
-        size_type _size  = 0ULL;
-        // Avoid construction of T's if T has a constructor
-        union {
-            char             a_byte = 0;
-            T                a_t;
-            std::array<T, N> store;
-        };
+        using array_type   = ::std::array<T, N>;
+        using union_type   = ::std::aligned_union<1, array_type>;
+        using storage_type = ::stack_vector::details::stack_vector_storage<T, N, Layout>;
+        using storage_type::_size;
+        using storage_type::store;
 
+        // counts an insert that didn't fit when telemetry is on
+        STACK_VECTOR_FORCEINLINE constexpr void count_overflow() noexcept {
+            ::stack_vector::telemetry::details::overflowed<T, N>();
+        }
         template <typename RetType>
-        __forceinline RetType return_error(RetType ret, [[maybe_unused]] const char *err_msg) {
+        STACK_VECTOR_FORCEINLINE constexpr RetType return_error(RetType ret,
+                                                                [[maybe_unused]] const char *err_msg) {
+            count_overflow();
             if constexpr (::stack_vector::details::error_handler ==
                           ::stack_vector::details::error_handling::_noop) {
                 return ret;
@@ -106,12 +402,7 @@ namespace stack_vector {
                 return ret;
             } else if (::stack_vector::details::error_handler ==
                        ::stack_vector::details::error_handling::_exception) {
-#if __clang__
-                throw std::bad_alloc();
-#else
-                throw std::bad_alloc(err_msg);
-#endif
-
+                ::stack_vector::details::report_full(err_msg);
                 return ret;
             } else if (::stack_vector::details::error_handler ==
                        ::stack_vector::details::error_handling::_error_code) {
@@ -125,6 +416,59 @@ namespace stack_vector {
             }
         };
 
+        // caps a resize to the capacity when saturating, false if the resize should not happen
+        constexpr bool fit_resize(size_type &count) {
+            if (count > capacity()) {
+                if constexpr (::stack_vector::details::error_handler !=
+                              ::stack_vector::details::error_handling::_saturate) {
+                    return_error(false, "stack_vector cannot allocate space to resize");
+                    return false;
+                }
+                count_overflow();
+                count = capacity();
+            }
+            return true;
+        }
+        // drops [begin() + count, end()), skipping destructors when they don't do anything
+        constexpr void shrink_to(size_type count) noexcept {
+            if constexpr (!::std::is_trivially_destructible<element_type>::value) {
+                ::stack_vector::details::destroy(begin() + count, end());
+            }
+            _size = count;
+        }
+
+        // slide [pos, end()) up by count in one pass from the back, leaving [pos, pos + count) uninitialized
+        constexpr void open_gap(pointer pos, size_type count) {
+            ::stack_vector::details::open_gap(pos, end(), count);
+            _size += count;
+        }
+        // the reverse, slide the tail back down over the uninitialized [pos, pos + count)
+        constexpr void close_gap(pointer pos, size_type count) {
+            ::stack_vector::details::close_gap(pos, end(), count);
+            _size -= count;
+        }
+        // construct count T's into an opened gap, closing it again if construction fails
+        template <class Fill> constexpr void fill_gap(pointer pos, size_type count, Fill &&fill) {
+            if constexpr (::std::is_nothrow_invocable<Fill, pointer, size_type>::value) {
+                fill(pos, count);
+            } else {
+                try {
+                    fill(pos, count);
+                } catch (...) {
+                    close_gap(pos, count);
+                    throw;
+                }
+            }
+        }
+        // whether value is one of our elements, so it would move while a gap is opened under it
+        constexpr bool is_ours(const T &value) const noexcept {
+            if (::std::is_constant_evaluated())
+                return true;
+            const T *ptr = ::std::addressof(value);
+            return ::std::less_equal<const T *>()(data(), ptr) &&
+                   ::std::less<const T *>()(ptr, data() + size());
+        }
+
         template <class It1> constexpr iterator insert_range(const_iterator pos, It1 first, It1 last) {
             // insert input range [first, last) at _Where
             size_type insert_idx = pos - cbegin();
@@ -134,36 +478,54 @@ namespace stack_vector {
             }
             assert(pos >= cbegin() && pos <= cend() &&
                    "insert iterator is out of bounds of the stack_vector");
-            const size_type old_size = size();
 
-            if constexpr (::std::is_same<::std::random_access_iterator_tag,
-                                         ::std::iterator_traits<It1>::iterator_category>::value) {
-                size_type insert_count = last - first;
+            if constexpr (::std::forward_iterator<It1>) {
+                // the count is known up front, open the gap once and copy straight into it
+                size_type insert_count = size_type(::std::distance(first, last));
                 if (insert_count > (capacity() - size())) { // error? or noop
-                    if constexpr (::stack_vector::details::error_handler !=
-                                  ::stack_vector::details::error_handling::_noop) {
-                        return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
-                    }
+                    return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
                 }
-                // already safe from check above*
-                ::stack_vector::details::uninitialized_copy_n(first, insert_count, end());
-                _size += insert_count;
+                open_gap(ret_it, insert_count);
+                fill_gap(ret_it, insert_count, [&first](pointer dest, size_type n) {
+                    ::stack_vector::details::uninitialized_copy_n(first, n, dest);
+                });
+                return ret_it;
+            } else if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // a single pass input, park the tail at the very back of the storage, read into the gap up to
+                // the capacity and slide the tail back down over what's left of it
+                const size_type tail_count = size() - insert_idx;
+                const size_type gap        = capacity() - size();
+                ::stack_vector::details::relocate_n(ret_it, tail_count, ret_it + gap);
+                _size            = insert_idx;
+                size_type filled = 0;
+                try {
+                    for (; first != last && filled < gap; ++first, ++filled)
+                        ::std::construct_at(ret_it + filled, *first);
+                } catch (...) {
+                    ::stack_vector::details::relocate_n(ret_it + gap, tail_count, ret_it + filled);
+                    _size = insert_idx + filled + tail_count;
+                    throw;
+                }
+                ::stack_vector::details::relocate_n(ret_it + gap, tail_count, ret_it + filled);
+                _size = insert_idx + filled + tail_count;
+                if (first != last) {
+                    return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
+                }
+                return ret_it;
             } else {
+                const size_type old_size = size();
                 // bounds check each emplace_back, saturating
                 for (; first != last && size() < capacity(); ++first) {
                     unchecked_emplace_back(*first);
                 }
+                // what fit goes into place before the rest is reported
+                ::std::rotate(begin() + insert_idx, begin() + old_size, end());
 
-                if constexpr (::stack_vector::details::error_handler !=
-                              ::stack_vector::details::error_handling::_noop) {
-                    if (first != last) {
-                        return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
-                    }
+                if (first != last) {
+                    return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
                 }
+                return ret_it;
             }
-
-            ::std::rotate(begin() + insert_idx, begin() + old_size, end());
-            return ret_it;
         }
 
         template <class It1> constexpr iterator append_range(It1 first, It1 last) {
@@ -174,13 +536,10 @@ namespace stack_vector {
             }
 
             if constexpr (::std::is_same<::std::random_access_iterator_tag,
-                                         ::std::iterator_traits<It1>::iterator_category>::value) {
+                                         typename ::std::iterator_traits<It1>::iterator_category>::value) {
                 size_type insert_count = last - first;
                 if (insert_count > (capacity() - size())) { // error? or noop
-                    if constexpr (::stack_vector::details::error_handler !=
-                                  ::stack_vector::details::error_handling::_noop) {
-                        return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
-                    }
+                    return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
                 }
                 // already safe from check above*
                 ::stack_vector::details::uninitialized_copy_n(first, insert_count, end());
@@ -190,11 +549,8 @@ namespace stack_vector {
                 for (; first != last && size() < capacity(); ++first) {
                     unchecked_emplace_back(*first);
                 }
-                if constexpr (::stack_vector::details::error_handler !=
-                              ::stack_vector::details::error_handling::_noop) {
-                    if (first != last) {
-                        return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
-                    }
+                if (first != last) {
+                    return ret_it = return_error(ret_it, "stack_vector cannot allocate space to insert");
                 }
             }
 
@@ -209,20 +565,40 @@ namespace stack_vector {
             assign(count, value);
         }
         constexpr explicit stack_vector(size_type count) {
-            assign(count, T());
+            resize(count);
         }
 
-        template <class It1> stack_vector(It1 first, It1 last) {
+        template <::std::input_iterator It1> constexpr stack_vector(It1 first, It1 last) {
             append(first, last);
         }
 
+        constexpr stack_vector(const stack_vector &other) requires
+            ::stack_vector::details::is_trivially_copyable_storage<T, N>
+        = default;
         constexpr stack_vector(const stack_vector &other) {
-            if (!other.empty())
+            if constexpr (::std::is_trivially_copyable<T>::value) {
+                ::stack_vector::details::copy_trivial_n(other.data(), other.size(), data());
+                _size = other._size;
+            } else if (!other.empty()) {
                 this->operator=(other);
+            }
         };
+        constexpr stack_vector(stack_vector &&other) noexcept requires
+            ::stack_vector::details::is_trivially_copyable_storage<T, N>
+        = default;
         constexpr stack_vector(stack_vector &&other) noexcept {
-            if (!other.empty())
+            if constexpr (::std::is_trivially_copyable<T>::value) {
+                // leaves other as is, like a std::array would be
+                ::stack_vector::details::copy_trivial_n(other.data(), other.size(), data());
+                _size = other._size;
+            } else if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // take other's elements, leaving it empty
+                ::stack_vector::details::relocate_disjoint_n(other.data(), other.size(), data());
+                _size       = other._size;
+                other._size = 0;
+            } else if (!other.empty()) {
                 this->operator=(::std::move(other));
+            }
         };
         constexpr stack_vector(::std::initializer_list<T> init) {
             assign(init);
@@ -233,14 +609,22 @@ namespace stack_vector {
         }
 
         // destructor
+        constexpr ~stack_vector() requires ::std::is_trivially_destructible<element_type>::value = default;
         constexpr ~stack_vector() {
-            if constexpr (!::std::is_trivially_destructible<element_type>::value)
-                ::stack_vector::details::destroy(begin(), end());
+            ::stack_vector::details::destroy(begin(), end());
         }
         // operator ='s
+        constexpr stack_vector &operator=(const stack_vector &other) requires
+            ::stack_vector::details::is_trivially_copyable_storage<T, N>
+        = default;
         constexpr stack_vector &operator=(const stack_vector &other) {
             if (this == &other)
                 return *this;
+            if constexpr (::std::is_trivially_copyable<T>::value) {
+                ::stack_vector::details::copy_trivial_n(other.data(), other.size(), data());
+                _size = other._size;
+                return *this;
+            }
             size_t rhs_size = other.size();
             size_t lhs_size = size();
             if (lhs_size >= rhs_size) {
@@ -263,11 +647,24 @@ namespace stack_vector {
                 return *this;
             }
         };
+        constexpr stack_vector &operator=(stack_vector &&other) noexcept requires
+            ::stack_vector::details::is_trivially_copyable_storage<T, N>
+        = default;
         constexpr stack_vector &operator=(stack_vector &&other) noexcept {
             size_t rhs_size = other.size();
             size_t lhs_size = size();
             if (this == &other) {
                 // do nothing
+            } else if constexpr (::std::is_trivially_copyable<T>::value) {
+                // leaves other as is, like a std::array would be
+                ::stack_vector::details::copy_trivial_n(other.data(), rhs_size, data());
+                _size = other._size;
+            } else if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // take other's elements, leaving it empty
+                clear();
+                ::stack_vector::details::relocate_disjoint_n(other.data(), rhs_size, data());
+                _size       = other._size;
+                other._size = 0;
             } else if (lhs_size >= rhs_size) {
                 // assign
                 iterator new_end;
@@ -302,36 +699,28 @@ namespace stack_vector {
                 ::stack_vector::details::uninitialized_fill_n(begin(), count, value);
                 _size = count;
             } else {
-                if constexpr (::stack_vector::details::error_handler !=
-                              ::stack_vector::details::error_handling::_noop) {
-                    return_error(false, "stack_vector cannot allocate space to insert");
-                }
+                return_error(false, "stack_vector cannot allocate space to insert");
             }
         };
-        template <class It1> constexpr void assign(It1 first, It1 last) {
+        template <::std::input_iterator It1> constexpr void assign(It1 first, It1 last) {
             if constexpr (::std::is_same<::std::random_access_iterator_tag,
-                                         ::std::iterator_traits<It1>::iterator_category>::value) {
+                                         typename ::std::iterator_traits<It1>::iterator_category>::value) {
                 size_type insert_count = last - first;
-                if ((size() + insert_count) <= capacity()) {
+                // the old elements are cleared first, they don't count against the capacity
+                if (insert_count <= capacity()) {
                     clear();
                     ::stack_vector::details::uninitialized_copy_n(first, insert_count, end());
                     _size = insert_count;
                 } else {
-                    if constexpr (::stack_vector::details::error_handler !=
-                                  ::stack_vector::details::error_handling::_noop) {
-                        return_error(false, "stack_vector cannot allocate space to insert");
-                    }
+                    return_error(false, "stack_vector cannot allocate space to insert");
                 }
             } else {
                 clear();
                 for (; first != last && size() < capacity(); ++first) {
                     unchecked_emplace_back(*first);
                 }
-                if constexpr (::stack_vector::details::error_handler !=
-                              ::stack_vector::details::error_handling::_noop) {
-                    if (first != last) {
-                        return_error(false, "stack_vector cannot allocate space to insert");
-                    }
+                if (first != last) {
+                    return_error(false, "stack_vector cannot allocate space to insert");
                 }
             }
         };
@@ -339,21 +728,59 @@ namespace stack_vector {
             assign(ilist.begin(), ilist.end());
         };
         // append's (non-standard)
-        void append(size_type count, const T &value) {
+        constexpr void append(size_type count, const T &value) {
             size_t space_remaining = capacity() - size();
             if (count && count <= space_remaining) [[likely]] {
                 ::stack_vector::details::uninitialized_fill_n(end(), count, value);
                 _size += count;
-            } else {
-                if constexpr (::stack_vector::details::error_handler !=
-                              ::stack_vector::details::error_handling::_noop) {
-                    return_error(false, "stack_vector cannot allocate space to insert");
-                }
+            } else if (count) {
+                return_error(false, "stack_vector cannot allocate space to insert");
             }
         }
-        template <typename It1> void append(It1 first, It1 last) {
+        template <::std::input_iterator It1> constexpr void append(It1 first, It1 last) {
             append_range(first, last);
         }
+        // spare_capacity (non-standard), the uninitialized [end(), data() + N) to be written to directly,
+        // construct into it then commit(n) the first n
+        [[nodiscard]] constexpr ::std::span<T> spare_capacity() noexcept {
+            return ::std::span<T>(end(), capacity() - size());
+        };
+        constexpr void commit(size_type count) noexcept {
+            assert(count <= (capacity() - size()) && "commit past the capacity of the stack_vector");
+            _size += count;
+        };
+        // resize_and_overwrite (non-standard for vector), op(data(), count) writes into [data(), data() + count)
+        // and returns how many elements are now live
+        template <class Operation> constexpr void resize_and_overwrite(size_type count, Operation op) {
+            static_assert(::std::is_trivially_copyable<T>::value && ::std::is_trivially_destructible<T>::value,
+                          "resize_and_overwrite can only hand out uninitialized trivial T's");
+            if (count > capacity()) {
+                if constexpr (::stack_vector::details::error_handler !=
+                              ::stack_vector::details::error_handling::_saturate) {
+                    return_error(false, "stack_vector cannot allocate space to resize");
+                    return;
+                }
+                count_overflow();
+                count = capacity();
+            }
+            const size_type new_size = static_cast<size_type>(::std::move(op)(data(), count));
+            assert(new_size <= count && "resize_and_overwrite operation reported more than it was given");
+            _size = new_size;
+        };
+        // resize_default_init (non-standard), new elements are default initialized, for trivial T's that means
+        // left as is
+        constexpr void resize_default_init(size_type count) {
+            if (!fit_resize(count))
+                return;
+            if (count <= size()) {
+                shrink_to(count);
+                return;
+            }
+            if constexpr (!::std::is_trivially_default_constructible<element_type>::value) {
+                ::stack_vector::details::uninitialized_default_construct(end(), begin() + count);
+            }
+            _size = count;
+        };
 
         // at's
         [[nodiscard]] constexpr reference at(size_type pos) {
@@ -463,10 +890,9 @@ namespace stack_vector {
             if constexpr (!::std::is_trivially_destructible<element_type>::value) {
                 ::stack_vector::details::destroy(begin(), end());
             }
-            _size = 0ULL;
+            _size = 0;
         };
-        // insert's TODO!
-        // be sure to verify range
+        // insert's
         constexpr iterator insert(const_iterator pos, const T &value) {
             return emplace(pos, value);
         };
@@ -474,50 +900,43 @@ namespace stack_vector {
             return emplace(pos, ::std::move(value));
         };
         constexpr iterator insert(const_iterator pos, size_type count, const T &value) {
-            const pointer insert_ptr = &(*pos);
-            const pointer old_begin  = &(*begin());
-            const pointer old_end    = &(*end());
-            const pointer new_end    = old_end + count;
-            const T      *value_ptr  = &value;
+            const pointer insert_ptr = begin() + (pos - cbegin());
 
             assert(pos >= cbegin() && pos <= cend() &&
                    "insert iterator is out of bounds of the stack_vector");
 
-            size_type  remaining_capacity = capacity() - size();
-            const bool one_at_back        = (count == 1) && (insert_ptr == old_end);
-            if (count == 0) {                        // do nothing
-            } else if (count > remaining_capacity) { // error?
+            const size_type remaining_capacity = capacity() - size();
+            if (count > remaining_capacity) {
                 if constexpr (::stack_vector::details::error_handler ==
-                              ::stack_vector::details::error_handling::_exception) {
-#if __clang__
-                    throw std::bad_alloc();
-#else
-                    throw std::bad_alloc("stack_vector cannot allocate to insert elements");
-#endif
-                } else if (::stack_vector::details::error_handler ==
-                           ::stack_vector::details::error_handling::_error_code) {
-                    return iterator(insert_ptr + 1);
-                } else if (::stack_vector::details::error_handler ==
-                           ::stack_vector::details::error_handling::_noop) {
-                    return iterator(insert_ptr);
-                } else if (::stack_vector::details::error_handler ==
-                           ::stack_vector::details::error_handling::_saturate) {
-                    T tmp = value;
-                    std::move_backward(insert_ptr, old_end, old_end + remaining_capacity);
-                    ::stack_vector::details::uninitialized_fill_n(pos, remaining_capacity, tmp);
-                    _size += count;
+                              ::stack_vector::details::error_handling::_saturate) {
+                    count_overflow();
+                    count = remaining_capacity;
+                } else {
+                    return return_error(iterator(insert_ptr),
+                                        "stack_vector cannot allocate to insert elements");
                 }
-            } else if (one_at_back) {
-                unchecked_emplace_back(value);
+            }
+            if (!count)
+                return iterator(insert_ptr);
+            auto fill = [this, insert_ptr, count](const T &fill_value) {
+                open_gap(insert_ptr, count);
+                auto copy = [&fill_value](pointer dest, size_type n) noexcept(
+                                ::std::is_nothrow_copy_constructible_v<T>) {
+                    ::stack_vector::details::uninitialized_fill_n(dest, n, fill_value);
+                };
+                fill_gap(insert_ptr, count, copy);
+            };
+            if (is_ours(value)) {
+                // value would move with the tail, copy it out first
+                const T tmp = value;
+                fill(tmp);
             } else {
-                T tmp = value;
-                std::move_backward(insert_ptr, old_end, old_end + count);
-                ::stack_vector::details::uninitialized_fill_n(pos, count, tmp); // ok?
-                _size += count;
+                fill(value);
             }
             return iterator(insert_ptr);
         };
-        template <class InputIt> constexpr iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        template <::std::input_iterator InputIt>
+        constexpr iterator insert(const_iterator pos, InputIt first, InputIt last) {
             return insert_range(pos, first, last);
         };
         constexpr iterator insert(const_iterator pos, ::std::initializer_list<T> ilist) {
@@ -529,7 +948,7 @@ namespace stack_vector {
             iterator  ret_it     = begin() + insert_idx;
             if (pos == cend()) { // special case for empty vector
                 if (!full()) [[likely]] {
-                    ::new ((void *)ret_it) T(::std::forward<Args>(args)...);
+                    ::std::construct_at(ret_it, ::std::forward<Args>(args)...);
                     _size += 1;
                     return ret_it;
                 } else { // error?
@@ -543,17 +962,35 @@ namespace stack_vector {
             if (full()) {
                 return ret_it = return_error(ret_it, "stack_vector cannot allocate to insert elements");
             }
+            if constexpr (sizeof...(Args) == 1 &&
+                          (::std::is_same<::std::remove_cvref_t<Args>, T>::value && ...)) {
+                // a T that isn't one of ours doesn't move when the gap opens, it goes straight in
+                if (!is_ours(args...)) {
+                    open_gap(ret_it, 1);
+                    fill_gap(ret_it, 1, [&](pointer dest, size_type) {
+                        ::std::construct_at(dest, ::std::forward<Args>(args)...);
+                    });
+                    return ret_it;
+                }
+            }
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                if (!::std::is_constant_evaluated()) {
+                    // build first (args may refer to our own elements), then slide the tail and drop it in
+                    alignas(T) unsigned char tmp_bytes[sizeof(T)];
+                    T *tmp_ptr = ::new ((void *)tmp_bytes) T(::std::forward<Args>(args)...);
+                    ::stack_vector::details::relocate_n(ret_it, size() - insert_idx, ret_it + 1);
+                    ::stack_vector::details::relocate_disjoint_n(tmp_ptr, 1, ret_it);
+                    _size += 1;
+                    return ret_it;
+                }
+            }
+            // args may refer to our own elements, build first then move it into the opened gap
             T tmp = T(::std::forward<Args>(args)...);
-            // placement new back item, eg... ...insert here, a, b, c, end -> ...insert
-            // here, a, a, b, c, (end)
-            ::new ((void *)end()) T(::std::move(back()));
-            // first last, destination
-            ::std::move_backward(begin() + insert_idx, end() - 1, end());
-            // up the size
-            _size += 1;
-            // insert the value
-            *ret_it = ::std::move(tmp);
-
+            open_gap(ret_it, 1);
+            auto build = [&tmp](pointer dest, size_type) noexcept(::std::is_nothrow_move_constructible_v<T>) {
+                ::std::construct_at(dest, ::std::move(tmp));
+            };
+            fill_gap(ret_it, 1, build);
             return ret_it;
         };
 
@@ -566,34 +1003,28 @@ namespace stack_vector {
         };
         // shove_back's (unchecked_push_back)
         constexpr void shove_back(const T &value) {
-            ::new ((void *)end()) T(::std::forward<const T &>(value));
+            ::std::construct_at(end(), ::std::forward<const T &>(value));
             _size += 1;
         }
         constexpr void shove_back(T &&value) {
-            ::new ((void *)end()) T(::std::forward<T &&>(value));
+            ::std::construct_at(end(), ::std::forward<T &&>(value));
             _size += 1;
         }
         // emplace_back's
         template <class... Args> constexpr reference emplace_back(Args &&...args) {
             iterator it = end();
             if (size() < capacity()) [[likely]] {
-                ::new ((void *)it) T(::std::forward<Args>(args)...);
+                ::std::construct_at(it, ::std::forward<Args>(args)...);
                 _size += 1;
             } else { // error?
-                if constexpr (::stack_vector::details::error_handler ==
-                              ::stack_vector::details::error_handling::_exception) {
-#if __clang__
-                    throw std::bad_alloc();
-#else
-                    throw std::bad_alloc("stack_vector cannot allocate to insert elements");
-#endif
-                }
+                count_overflow();
+                ::stack_vector::details::report_full("stack_vector cannot allocate to insert elements");
             }
             return *it;
         };
         template <class... Args> constexpr reference unchecked_emplace_back(Args &&...args) {
             iterator it = end();
-            ::new ((void *)it) T(::std::forward<Args>(args)...);
+            ::std::construct_at(it, ::std::forward<Args>(args)...);
             _size += 1;
             return *it;
         };
@@ -620,6 +1051,14 @@ namespace stack_vector {
             size_type erase_idx = pos - cbegin();
 
             assert(pos >= cbegin() && pos <= cend() && "erase iterator is out of bounds of the stack_vector");
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // destroy and slide the tail over the hole
+                iterator dest = begin() + erase_idx;
+                ::stack_vector::details::destroy_at(dest);
+                ::stack_vector::details::relocate_n(dest + 1, size() - erase_idx - 1, dest);
+                _size -= 1;
+                return dest;
+            }
             // move on top
             iterator first = begin() + erase_idx + 1;
             iterator last  = end();
@@ -641,7 +1080,17 @@ namespace stack_vector {
             assert(last >= cbegin() && last <= cend() &&
                    "last erase iterator is out of bounds of the stack_vector");
 
-            if (first != last) {
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                if (first != last) {
+                    // destroy and slide the tail over the hole
+                    size_type erase_count = last - first;
+                    iterator  dest        = begin() + erase_idx;
+                    ::stack_vector::details::destroy(dest, dest + erase_count);
+                    ::stack_vector::details::relocate_n(dest + erase_count, size() - erase_idx - erase_count,
+                                                        dest);
+                    _size -= erase_count;
+                }
+            } else if (first != last) {
                 size_type erase_count = last - first;
                 iterator  _first      = begin() + (erase_idx + erase_count);
                 iterator  _last       = end();
@@ -655,27 +1104,243 @@ namespace stack_vector {
             return begin() + erase_idx;
         }
 
-        // resize's (unimplemented or noop)
+        // erase_indices (non-standard), erases the elements at the sorted, unique indices in one pass, each
+        // kept run slides down once, returns how many were erased
+        constexpr size_type erase_indices(::std::span<const size_type> indices) noexcept(
+            ::std::is_nothrow_move_assignable_v<value_type>) {
+            if (indices.empty())
+                return 0;
+            const pointer base = data();
+            size_type     dest = indices[0];
+            for (size_type k = 0; k < indices.size(); k++) {
+                const size_type first = indices[k] + 1;
+                const size_type last  = k + 1 < indices.size() ? indices[k + 1] : size();
+                assert(indices[k] < size() && first <= last && "erase_indices needs sorted, unique indices");
+                if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                    ::stack_vector::details::destroy_at(base + indices[k]);
+                    ::stack_vector::details::relocate_n(base + first, last - first, base + dest);
+                } else {
+                    ::std::move(base + first, base + last, base + dest);
+                }
+                dest += last - first;
+            }
+            if constexpr (!::stack_vector::is_trivially_relocatable_v<T>)
+                ::stack_vector::details::destroy(base + dest, end());
+            const size_type erased = size() - dest;
+            _size                  = dest;
+            return erased;
+        }
+        // swap_erase (non-standard), the last element takes pos's place, O(1) but the order changes
+        constexpr iterator
+        swap_erase(const_iterator pos) noexcept(::std::is_nothrow_move_assignable_v<value_type>) {
+            assert(pos >= cbegin() && pos < cend() &&
+                   "swap_erase iterator is out of bounds of the stack_vector");
+            const iterator dest = begin() + (pos - cbegin());
+            const iterator last = end() - 1;
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::destroy_at(dest);
+                ::stack_vector::details::relocate_n(last, 1, dest);
+            } else {
+                if (dest != last)
+                    *dest = ::std::move(*last);
+                ::stack_vector::details::destroy_at(last);
+            }
+            _size -= 1;
+            return dest;
+        }
+        // erase_unordered (non-standard), elements from the back fill [first, last), so it costs
+        // O(last - first) rather than the length of the tail
+        constexpr iterator
+        erase_unordered(const_iterator first,
+                        const_iterator last) noexcept(::std::is_nothrow_move_assignable_v<value_type>) {
+            assert(first >= cbegin() && first <= last && last <= cend() &&
+                   "erase_unordered iterators are out of bounds of the stack_vector");
+            const iterator  dest        = begin() + (first - cbegin());
+            const size_type erase_count = size_type(last - first);
+            const size_type fill_count  = ::std::min<size_type>(erase_count, size_type(cend() - last));
+            const iterator  src         = end() - fill_count;
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                ::stack_vector::details::destroy(dest, dest + erase_count);
+                ::stack_vector::details::relocate_n(src, fill_count, dest);
+            } else {
+                ::std::move(src, end(), dest);
+                ::stack_vector::details::destroy(end() - erase_count, end());
+            }
+            _size -= erase_count;
+            return dest;
+        }
+        // insert_many (non-standard), values[i] goes in before the element at positions[i] (an index into
+        // the vector as it was, sorted, repeats allowed). All the gaps are opened in one pass from the back,
+        // values must not point into the vector. False if they don't all fit. If a copy throws the size is
+        // left as it was, every element is still alive but may have been moved from.
+        constexpr bool insert_many(::std::span<const size_type> positions, ::std::span<const T> values) {
+            assert(positions.size() == values.size() && "insert_many needs a position for every value");
+            const size_type count = values.size();
+            if (!count)
+                return true;
+            if (count > capacity() - size())
+                return return_error(false, "stack_vector cannot allocate space to insert");
+            const pointer   base     = data();
+            const size_type old_size = size();
+            // writes go from the back, [built, old_size + count) is what's been constructed past the end
+            size_type built = old_size + count;
+            // writes into index i, constructing past the old end and assigning before it
+            auto put = [base, old_size, &built](size_type i, auto &&value) {
+                if (i >= old_size) {
+                    ::std::construct_at(base + i, ::std::forward<decltype(value)>(value));
+                    built = i;
+                } else {
+                    base[i] = ::std::forward<decltype(value)>(value);
+                }
+            };
+            size_type src_end = old_size;
+            for (size_type j = count; j-- > 0;) {
+                const size_type pos = positions[j];
+                assert(pos <= src_end && "insert_many needs sorted positions");
+                // [pos, src_end) moves up past the j + 1 values going in at or before it, relocating only
+                // when nothing can throw partway through, a relocated tail can't be put back
+                if constexpr (::stack_vector::is_trivially_relocatable_v<T> &&
+                              ::std::is_nothrow_copy_constructible<T>::value) {
+                    ::stack_vector::details::relocate_n(base + pos, src_end - pos, base + pos + j + 1);
+                    ::std::construct_at(base + pos + j, values[j]);
+                } else {
+                    try {
+                        for (size_type i = src_end; i-- > pos;)
+                            put(i + j + 1, ::std::move(base[i]));
+                        put(pos + j, values[j]);
+                    } catch (...) {
+                        ::stack_vector::details::destroy(base + built, base + old_size + count);
+                        throw;
+                    }
+                }
+                src_end = pos;
+            }
+            _size += count;
+            return true;
+        }
+        // resize's
+        constexpr void resize(size_type count) {
+            if (!fit_resize(count))
+                return;
+            if (count <= size()) {
+                shrink_to(count);
+                return;
+            }
+            if constexpr (::std::is_scalar<element_type>::value && !::std::is_member_pointer<element_type>::value) {
+                // value initialized scalars are all zero bits
+                if (!::std::is_constant_evaluated()) {
+                    ::std::memset((void *)end(), 0, (count - size()) * sizeof(T));
+                    _size = count;
+                    return;
+                }
+            }
+            ::stack_vector::details::uninitialized_value_construct(end(), begin() + count);
+            _size = count;
+        };
+        constexpr void resize(size_type count, const value_type &value) {
+            if (!fit_resize(count))
+                return;
+            if (count <= size()) {
+                shrink_to(count);
+                return;
+            }
+            // only the unused tail is written, so value may be one of ours
+            ::stack_vector::details::uninitialized_fill_n(end(), count - size(), value);
+            _size = count;
+        };
+        // sort's (non-standard), up to STACK_VECTOR_SORT_NETWORK_MAX small trivially copyable T's run
+        // through a sorting network, other T's are insertion sorted up to STACK_VECTOR_SORT_INSERTION_MAX,
+        // and larger sizes fall to pdqsort. A capacity no larger than that never instantiates pdqsort at
+        // all. Not stable.
+        template <class Compare = ::std::less<>> constexpr void sort(Compare comp = Compare{}) {
+            if constexpr (N <= ::stack_vector::sorting::details::small_sort_max<T>)
+                ::stack_vector::sorting::details::small_sort<N>(data(), data() + size(), comp, true);
+            else
+                ::stack_vector::sorting::sort(data(), size(), comp);
+        }
+        // partial_sort (non-standard), the middle - begin() smallest elements in order at the front, for the
+        // top k of a few candidates
+        template <class Compare = ::std::less<>>
+        constexpr void partial_sort(const_iterator middle, Compare comp = Compare{}) {
+            assert(middle >= cbegin() && middle <= cend() && "partial_sort iterator is out of bounds");
+            if constexpr (N <= ::stack_vector::sorting::details::small_sort_max<T>)
+                ::stack_vector::sorting::details::small_sort<N>(data(), data() + size(), comp, true);
+            else
+                ::stack_vector::sorting::partial_sort(data(), size_type(middle - cbegin()), size(), comp);
+        }
+        // nth_element (non-standard), nth holds what it would after sorting, nothing before it is greater
+        // and nothing after it less
+        template <class Compare = ::std::less<>>
+        constexpr void nth_element(const_iterator nth, Compare comp = Compare{}) {
+            assert(nth >= cbegin() && nth <= cend() && "nth_element iterator is out of bounds");
+            if constexpr (N <= ::stack_vector::sorting::details::small_sort_max<T>)
+                ::stack_vector::sorting::details::small_sort<N>(data(), data() + size(), comp, true);
+            else
+                ::stack_vector::sorting::nth_element(data(), size_type(nth - cbegin()), size(), comp);
+        }
         // swap's
         constexpr void swap(stack_vector &other) noexcept {
             if (this == &other)
                 return;
-            if constexpr (::std::is_pod<T>::value) {
-                // swap the data
-                ::std::swap(*reinterpret_cast<array_type *>(&store),
-                            *reinterpret_cast<array_type *>(&other.store));
+            // only the live elements are exchanged, the longer side hands its excess to the shorter
+            stack_vector   *longer  = size() >= other.size() ? this : &other;
+            stack_vector   *shorter = size() >= other.size() ? &other : this;
+            const size_type common  = shorter->size();
+            if constexpr (::stack_vector::is_trivially_relocatable_v<T>) {
+                // exchanging the bytes of relocatable T's exchanges the T's
+                ::stack_vector::details::swap_trivial_n(data(), other.data(), common);
+                ::stack_vector::details::relocate_disjoint_n(longer->data() + common, longer->size() - common,
+                                                             shorter->data() + common);
             } else {
-                stack_vector tmp = *this; // meh
-                assign(other);
-                other.assign(tmp);
+                ::std::swap_ranges(begin(), begin() + common, other.begin());
+                ::stack_vector::details::uninitialized_move(longer->begin() + common, longer->end(),
+                                                            shorter->begin() + common);
+                ::stack_vector::details::destroy(longer->begin() + common, longer->end());
             }
-            // swap the sizes
-            ::std::swap(_size, other._size);
+            // swap the sizes, a tracked size swaps its raw count without counting a temporary
+            using ::std::swap;
+            swap(_size, other._size);
         }
     };
-    template <class T, size_t N0, size_t N1>
-    [[nodiscard]] ::stack_vector::stack_vector<T, N0 + N1> __forceinline append(
-        const ::stack_vector::stack_vector<T, N0> &left, const ::stack_vector::stack_vector<T, N1> &right) {
+
+    // searches, vectorized for arithmetic T's
+    template <class T, size_t N, size_layout L, class U>
+    [[nodiscard]] constexpr typename ::stack_vector::stack_vector<T, N, L>::iterator
+    find(::stack_vector::stack_vector<T, N, L> &c, const U &value) {
+        if constexpr (::stack_vector::simd::kernel_comparable<T, U>) {
+            T needle{};
+            if (!::stack_vector::simd::narrow(value, needle))
+                return c.end();
+            return c.begin() + ::stack_vector::simd::find(c.data(), c.size(), needle);
+        } else {
+            return ::std::find(c.begin(), c.end(), value);
+        }
+    }
+    template <class T, size_t N, size_layout L, class U>
+    [[nodiscard]] constexpr typename ::stack_vector::stack_vector<T, N, L>::const_iterator
+    find(const ::stack_vector::stack_vector<T, N, L> &c, const U &value) {
+        return ::stack_vector::find(const_cast<::stack_vector::stack_vector<T, N, L> &>(c), value);
+    }
+    template <class T, size_t N, size_layout L, class U>
+    [[nodiscard]] constexpr size_t count(const ::stack_vector::stack_vector<T, N, L> &c, const U &value) {
+        if constexpr (::stack_vector::simd::kernel_comparable<T, U>) {
+            T needle{};
+            if (!::stack_vector::simd::narrow(value, needle))
+                return 0;
+            return ::stack_vector::simd::count(c.data(), c.size(), needle);
+        } else {
+            return size_t(::std::count(c.begin(), c.end(), value));
+        }
+    }
+    template <class T, size_t N, size_layout L, class U>
+    [[nodiscard]] constexpr bool contains(const ::stack_vector::stack_vector<T, N, L> &c, const U &value) {
+        return ::stack_vector::find(c, value) != c.end();
+    }
+
+    template <class T, size_t N0, size_layout L0, size_t N1, size_layout L1>
+    [[nodiscard]] STACK_VECTOR_FORCEINLINE constexpr ::stack_vector::stack_vector<T, N0 + N1>
+    append(const ::stack_vector::stack_vector<T, N0, L0> &left,
+           const ::stack_vector::stack_vector<T, N1, L1> &right) {
         ::stack_vector::stack_vector<T, N0 + N1> ret;
         ret.append(left.begin(), left.end());
         ret.append(right.begin(), right.end());
@@ -684,65 +1349,59 @@ namespace stack_vector {
 } // namespace stack_vector
 
 // non-members
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator==(const stack_vector::stack_vector<T, N0> &left,
-                              const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator==(const stack_vector::stack_vector<T, N0, L0> &left,
+                                        const stack_vector::stack_vector<T, N1, L1> &right) {
     return left.size() == right.size() && ::std::equal(left.begin(), left.end(), right.begin());
 }
 
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator!=(const stack_vector::stack_vector<T, N0> &left,
-                              const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator!=(const stack_vector::stack_vector<T, N0, L0> &left,
+                                        const stack_vector::stack_vector<T, N1, L1> &right) {
     return !(left == right);
 }
 
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator<(const stack_vector::stack_vector<T, N0> &left,
-                             const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator<(const stack_vector::stack_vector<T, N0, L0> &left,
+                                       const stack_vector::stack_vector<T, N1, L1> &right) {
     return ::std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
 }
 
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator>(const stack_vector::stack_vector<T, N0> &left,
-                             const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator>(const stack_vector::stack_vector<T, N0, L0> &left,
+                                       const stack_vector::stack_vector<T, N1, L1> &right) {
     return right < left;
 }
 
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator<=(const stack_vector::stack_vector<T, N0> &left,
-                              const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator<=(const stack_vector::stack_vector<T, N0, L0> &left,
+                                        const stack_vector::stack_vector<T, N1, L1> &right) {
     return !(right < left);
 }
 
-template <class T, size_t N0, size_t N1>
-[[nodiscard]] bool operator>=(const stack_vector::stack_vector<T, N0> &left,
-                              const stack_vector::stack_vector<T, N1> &right) {
+template <class T, size_t N0, stack_vector::size_layout L0, size_t N1, stack_vector::size_layout L1>
+[[nodiscard]] constexpr bool operator>=(const stack_vector::stack_vector<T, N0, L0> &left,
+                                        const stack_vector::stack_vector<T, N1, L1> &right) {
     return !(left < right);
 }
 
 namespace std {
     // conditional erases
-    template <class T, size_t N, class U>
-    constexpr typename stack_vector::stack_vector<T, N>::size_type erase(stack_vector::stack_vector<T, N> &c,
-                                                                         const U &value) {
-        auto it = ::std::remove(c.begin(), c.end(), value);
-        auto r  = ::std::distance(it, c.end());
-        c.erase(it, c.end());
-        return r;
+    template <class T, size_t N, stack_vector::size_layout L, class U>
+    constexpr typename stack_vector::stack_vector<T, N, L>::size_type
+    erase(stack_vector::stack_vector<T, N, L> &c, const U &value) {
+        return ::stack_vector::details::erase_value(c, value);
     }
 
-    template <class T, size_t N, class Pred>
-    constexpr typename stack_vector::stack_vector<T, N>::size_type
-    erase_if(stack_vector::stack_vector<T, N> &c, Pred pred) {
-        auto it = ::std::remove_if(c.begin(), c.end(), pred);
-        auto r  = ::std::distance(it, c.end());
-        c.erase(it, c.end());
-        return r;
+    template <class T, size_t N, stack_vector::size_layout L, class Pred>
+    constexpr typename stack_vector::stack_vector<T, N, L>::size_type
+    erase_if(stack_vector::stack_vector<T, N, L> &c, Pred pred) {
+        return ::stack_vector::details::erase_value_if(c, pred);
     };
 
-    template <class T, size_t N>
-    constexpr void swap(::stack_vector::stack_vector<T, N> &left,
-                        ::stack_vector::stack_vector<T, N> &right) noexcept {
+    template <class T, size_t N, ::stack_vector::size_layout L>
+    constexpr void swap(::stack_vector::stack_vector<T, N, L> &left,
+                        ::stack_vector::stack_vector<T, N, L> &right) noexcept {
         left.swap(right);
     }
 }; // namespace std
\ No newline at end of file
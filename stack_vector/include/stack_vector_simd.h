@@ -0,0 +1,469 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// define STACK_VECTOR_NO_SIMD to keep to the scalar kernels
+#if !defined(STACK_VECTOR_NO_SIMD) &&                                                                         \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STACK_VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define STACK_VECTOR_TARGET_AVX2
+#else
+#define STACK_VECTOR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define STACK_VECTOR_SIMD_X86 0
+#endif
+
+#ifndef STACK_VECTOR_FORCEINLINE
+#if defined(_MSC_VER)
+#define STACK_VECTOR_FORCEINLINE __forceinline
+#else
+#define STACK_VECTOR_FORCEINLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace stack_vector {
+    namespace simd {
+        // element types with vector kernels, matched the same way == matches them
+        template <typename T>
+        concept kernel_type = ::std::is_arithmetic<T>::value &&
+                              (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        enum class isa_level : uint8_t { _scalar, _sse2, _avx2 };
+
+        inline isa_level supported_isa() noexcept {
+#if STACK_VECTOR_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] >= 7) {
+                __cpuid(info, 1);
+                const bool osxsave = (info[2] & (1 << 27)) != 0;
+                const bool avx     = (info[2] & (1 << 28)) != 0;
+                if (osxsave && avx && (_xgetbv(0) & 6) == 6) {
+                    __cpuidex(info, 7, 0);
+                    if (info[1] & (1 << 5))
+                        return isa_level::_avx2;
+                }
+            }
+            return isa_level::_sse2;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? isa_level::_avx2 : isa_level::_sse2;
+#endif
+#else
+            return isa_level::_scalar;
+#endif
+        }
+
+        // the kernels used, picked once at startup (anything running earlier sees _scalar), may be
+        // lowered to force a narrower path but never raised past supported_isa()
+        inline isa_level active_isa = ::stack_vector::simd::supported_isa();
+
+        namespace details {
+            template <typename T>
+            concept standard_integer =
+                ::std::is_integral<T>::value && !::std::is_same<T, bool>::value &&
+                !::std::is_same<T, char>::value && !::std::is_same<T, wchar_t>::value &&
+                !::std::is_same<T, char8_t>::value && !::std::is_same<T, char16_t>::value &&
+                !::std::is_same<T, char32_t>::value;
+
+            template <typename T> constexpr size_t find_scalar(const T *first, size_t count, T value) noexcept {
+                size_t i = 0;
+                for (; i < count; i++) {
+                    if (first[i] == value)
+                        break;
+                }
+                return i;
+            }
+            template <typename T> constexpr size_t count_scalar(const T *first, size_t count, T value) noexcept {
+                size_t ret = 0;
+                for (size_t i = 0; i < count; i++)
+                    ret += size_t(first[i] == value);
+                return ret;
+            }
+            template <typename T> constexpr size_t count_less_scalar(const T *first, size_t count, T value) noexcept {
+                size_t ret = 0;
+                for (size_t i = 0; i < count; i++)
+                    ret += size_t(first[i] < value);
+                return ret;
+            }
+            // every element is written, only the write position depends on the predicate
+            template <typename T, typename Pred> constexpr size_t remove_if_scalar(T *first, size_t count, Pred &pred) {
+                size_t kept = 0;
+                for (size_t i = 0; i < count; i++) {
+                    const bool drop = bool(pred(first[i]));
+                    first[kept]     = first[i];
+                    kept += size_t(!drop);
+                }
+                return kept;
+            }
+            template <typename T> constexpr size_t remove_scalar(T *first, size_t count, T value) noexcept {
+                size_t kept = 0;
+                for (size_t i = 0; i < count; i++) {
+                    const T v   = first[i];
+                    first[kept] = v;
+                    kept += size_t(!(v == value));
+                }
+                return kept;
+            }
+
+            // lane indices for an in place compress, entry m lists the lanes set in m first (a byte each)
+            struct compress_tables {
+                uint64_t lanes32[256];
+                uint64_t lanes64[16];
+            };
+            constexpr compress_tables make_compress_tables() noexcept {
+                compress_tables ret{};
+                for (unsigned m = 0; m < 256; m++) {
+                    unsigned out = 0;
+                    for (unsigned lane = 0; lane < 8; lane++) {
+                        if (m & (1u << lane))
+                            ret.lanes32[m] |= uint64_t(lane) << (8 * out++);
+                    }
+                    for (; out < 8; out++)
+                        ret.lanes32[m] |= uint64_t(out) << (8 * out);
+                }
+                for (unsigned m = 0; m < 16; m++) {
+                    unsigned out = 0;
+                    for (unsigned lane = 0; lane < 4; lane++) {
+                        if (m & (1u << lane)) {
+                            ret.lanes64[m] |= uint64_t(2 * lane) << (8 * out++);
+                            ret.lanes64[m] |= uint64_t(2 * lane + 1) << (8 * out++);
+                        }
+                    }
+                    for (; out < 8; out++)
+                        ret.lanes64[m] |= uint64_t(out) << (8 * out);
+                }
+                return ret;
+            }
+            inline constexpr compress_tables compress_table = make_compress_tables();
+
+#if STACK_VECTOR_SIMD_X86
+            template <typename T> STACK_VECTOR_FORCEINLINE __m128i splat_sse2(T value) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_set1_epi8(::std::bit_cast<char>(value));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_set1_epi16(::std::bit_cast<short>(value));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_set1_epi32(::std::bit_cast<int>(value));
+                else
+                    return _mm_set1_epi64x(::std::bit_cast<long long>(value));
+            }
+            // sizeof(T) mask bits per lane
+            template <typename T> STACK_VECTOR_FORCEINLINE unsigned equal_mask_sse2(const T *at, __m128i needle) noexcept {
+                const __m128i block = _mm_loadu_si128((const __m128i *)at);
+                __m128i       eq;
+                if constexpr (::std::is_floating_point<T>::value && sizeof(T) == 4) {
+                    eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+                } else if constexpr (::std::is_floating_point<T>::value) {
+                    eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+                } else if constexpr (sizeof(T) == 1) {
+                    eq = _mm_cmpeq_epi8(block, needle);
+                } else if constexpr (sizeof(T) == 2) {
+                    eq = _mm_cmpeq_epi16(block, needle);
+                } else if constexpr (sizeof(T) == 4) {
+                    eq = _mm_cmpeq_epi32(block, needle);
+                } else {
+                    // no 64 bit compare before sse4.1, both halves have to match
+                    const __m128i half = _mm_cmpeq_epi32(block, needle);
+                    eq                 = _mm_and_si128(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+                }
+                return unsigned(_mm_movemask_epi8(eq));
+            }
+            template <typename T> size_t find_sse2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 16 / sizeof(T);
+                const __m128i    needle = splat_sse2(value);
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes) {
+                    const unsigned mask = equal_mask_sse2(first + i, needle);
+                    if (mask)
+                        return i + size_t(::std::countr_zero(mask)) / sizeof(T);
+                }
+                return i + find_scalar(first + i, count - i, value);
+            }
+            template <typename T> size_t count_sse2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 16 / sizeof(T);
+                const __m128i    needle = splat_sse2(value);
+                size_t           bits   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes)
+                    bits += size_t(::std::popcount(equal_mask_sse2(first + i, needle)));
+                return bits / sizeof(T) + count_scalar(first + i, count - i, value);
+            }
+
+            // only signed compares below 64 bits, unsigned lanes are flipped into signed order first
+            template <typename T>
+            constexpr bool has_less_sse2 = ::std::is_floating_point<T>::value || sizeof(T) < 8;
+            template <typename T> STACK_VECTOR_FORCEINLINE __m128i sign_flip_sse2(__m128i block) noexcept {
+                if constexpr (::std::is_floating_point<T>::value || ::std::is_signed<T>::value)
+                    return block;
+                else if constexpr (sizeof(T) == 1)
+                    return _mm_xor_si128(block, _mm_set1_epi8(char(0x80)));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_xor_si128(block, _mm_set1_epi16(short(0x8000)));
+                else
+                    return _mm_xor_si128(block, _mm_set1_epi32(int(0x80000000u)));
+            }
+            template <typename T> STACK_VECTOR_FORCEINLINE unsigned less_mask_sse2(const T *at, __m128i needle) noexcept {
+                const __m128i block = sign_flip_sse2<T>(_mm_loadu_si128((const __m128i *)at));
+                __m128i       lt;
+                if constexpr (::std::is_floating_point<T>::value && sizeof(T) == 4)
+                    lt = _mm_castps_si128(_mm_cmplt_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+                else if constexpr (::std::is_floating_point<T>::value)
+                    lt = _mm_castpd_si128(_mm_cmplt_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+                else if constexpr (sizeof(T) == 1)
+                    lt = _mm_cmpgt_epi8(needle, block);
+                else if constexpr (sizeof(T) == 2)
+                    lt = _mm_cmpgt_epi16(needle, block);
+                else
+                    lt = _mm_cmpgt_epi32(needle, block);
+                return unsigned(_mm_movemask_epi8(lt));
+            }
+            template <typename T> size_t count_less_sse2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 16 / sizeof(T);
+                const __m128i    needle = sign_flip_sse2<T>(splat_sse2(value));
+                size_t           bits   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes)
+                    bits += size_t(::std::popcount(less_mask_sse2(first + i, needle)));
+                return bits / sizeof(T) + count_less_scalar(first + i, count - i, value);
+            }
+
+            template <typename T> STACK_VECTOR_TARGET_AVX2 inline __m256i splat_avx2(T value) noexcept {
+                if constexpr (sizeof(T) == 1)
+                    return _mm256_set1_epi8(::std::bit_cast<char>(value));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_set1_epi16(::std::bit_cast<short>(value));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_set1_epi32(::std::bit_cast<int>(value));
+                else
+                    return _mm256_set1_epi64x(::std::bit_cast<long long>(value));
+            }
+            // all ones in the lanes equal to needle
+            template <typename T>
+            STACK_VECTOR_TARGET_AVX2 inline __m256i equal_avx2(__m256i block, __m256i needle) noexcept {
+                if constexpr (::std::is_floating_point<T>::value && sizeof(T) == 4) {
+                    return _mm256_castps_si256(
+                        _mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(needle), _CMP_EQ_OQ));
+                } else if constexpr (::std::is_floating_point<T>::value) {
+                    return _mm256_castpd_si256(
+                        _mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(needle), _CMP_EQ_OQ));
+                } else if constexpr (sizeof(T) == 1) {
+                    return _mm256_cmpeq_epi8(block, needle);
+                } else if constexpr (sizeof(T) == 2) {
+                    return _mm256_cmpeq_epi16(block, needle);
+                } else if constexpr (sizeof(T) == 4) {
+                    return _mm256_cmpeq_epi32(block, needle);
+                } else {
+                    return _mm256_cmpeq_epi64(block, needle);
+                }
+            }
+            template <typename T>
+            STACK_VECTOR_TARGET_AVX2 inline unsigned equal_mask_avx2(const T *at, __m256i needle) noexcept {
+                return unsigned(_mm256_movemask_epi8(equal_avx2<T>(_mm256_loadu_si256((const __m256i *)at), needle)));
+            }
+            template <typename T> STACK_VECTOR_TARGET_AVX2 size_t find_avx2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 32 / sizeof(T);
+                const __m256i    needle = splat_avx2(value);
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes) {
+                    const unsigned mask = equal_mask_avx2(first + i, needle);
+                    if (mask)
+                        return i + size_t(::std::countr_zero(mask)) / sizeof(T);
+                }
+                return i + find_scalar(first + i, count - i, value);
+            }
+            template <typename T> STACK_VECTOR_TARGET_AVX2 size_t count_avx2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 32 / sizeof(T);
+                const __m256i    needle = splat_avx2(value);
+                size_t           bits   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes)
+                    bits += size_t(::std::popcount(equal_mask_avx2(first + i, needle)));
+                return bits / sizeof(T) + count_scalar(first + i, count - i, value);
+            }
+            template <typename T> STACK_VECTOR_TARGET_AVX2 inline __m256i sign_flip_avx2(__m256i block) noexcept {
+                if constexpr (::std::is_floating_point<T>::value || ::std::is_signed<T>::value)
+                    return block;
+                else if constexpr (sizeof(T) == 1)
+                    return _mm256_xor_si256(block, _mm256_set1_epi8(char(0x80)));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm256_xor_si256(block, _mm256_set1_epi16(short(0x8000)));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm256_xor_si256(block, _mm256_set1_epi32(int(0x80000000u)));
+                else
+                    return _mm256_xor_si256(block, _mm256_set1_epi64x((long long)(0x8000000000000000ull)));
+            }
+            template <typename T>
+            STACK_VECTOR_TARGET_AVX2 inline unsigned less_mask_avx2(const T *at, __m256i needle) noexcept {
+                const __m256i block = sign_flip_avx2<T>(_mm256_loadu_si256((const __m256i *)at));
+                __m256i       lt;
+                if constexpr (::std::is_floating_point<T>::value && sizeof(T) == 4)
+                    lt = _mm256_castps_si256(
+                        _mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(needle), _CMP_LT_OQ));
+                else if constexpr (::std::is_floating_point<T>::value)
+                    lt = _mm256_castpd_si256(
+                        _mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(needle), _CMP_LT_OQ));
+                else if constexpr (sizeof(T) == 1)
+                    lt = _mm256_cmpgt_epi8(needle, block);
+                else if constexpr (sizeof(T) == 2)
+                    lt = _mm256_cmpgt_epi16(needle, block);
+                else if constexpr (sizeof(T) == 4)
+                    lt = _mm256_cmpgt_epi32(needle, block);
+                else
+                    lt = _mm256_cmpgt_epi64(needle, block);
+                return unsigned(_mm256_movemask_epi8(lt));
+            }
+            template <typename T>
+            STACK_VECTOR_TARGET_AVX2 size_t count_less_avx2(const T *first, size_t count, T value) noexcept {
+                constexpr size_t lanes  = 32 / sizeof(T);
+                const __m256i    needle = sign_flip_avx2<T>(splat_avx2(value));
+                size_t           bits   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes)
+                    bits += size_t(::std::popcount(less_mask_avx2(first + i, needle)));
+                return bits / sizeof(T) + count_less_scalar(first + i, count - i, value);
+            }
+            // compress store, each block's kept lanes are permuted to the front and stored at the write
+            // position, which never passes the block just read
+            template <typename T>
+            STACK_VECTOR_TARGET_AVX2 size_t remove_avx2(T *first, size_t count, T value) noexcept {
+                static_assert(sizeof(T) == 4 || sizeof(T) == 8, "compress store works on 32 or 64 bit lanes");
+                constexpr size_t lanes  = 32 / sizeof(T);
+                const __m256i    needle = splat_avx2(value);
+                size_t           kept   = 0;
+                size_t           i      = 0;
+                for (; i + lanes <= count; i += lanes) {
+                    const __m256i block = _mm256_loadu_si256((const __m256i *)(first + i));
+                    const __m256i eq    = equal_avx2<T>(block, needle);
+                    unsigned      keep;
+                    const void   *indices;
+                    if constexpr (sizeof(T) == 4) {
+                        keep    = ~unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) & 0xffu;
+                        indices = &compress_table.lanes32[keep];
+                    } else {
+                        keep    = ~unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) & 0xfu;
+                        indices = &compress_table.lanes64[keep];
+                    }
+                    const __m256i perm = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)indices));
+                    _mm256_storeu_si256((__m256i *)(first + kept), _mm256_permutevar8x32_epi32(block, perm));
+                    kept += size_t(::std::popcount(keep));
+                }
+                for (; i < count; i++) {
+                    const T v   = first[i];
+                    first[kept] = v;
+                    kept += size_t(!(v == value));
+                }
+                return kept;
+            }
+#endif
+        } // namespace details
+
+        // a U the kernels can look for among T's, the same type or another integer
+        template <typename T, typename U>
+        concept kernel_comparable =
+            kernel_type<T> && (::std::is_same<T, U>::value ||
+                               (details::standard_integer<T> && details::standard_integer<U>));
+
+        // the one T that == value, false when there's none. == converts both sides to their common type,
+        // which is at least as wide as T, so only T(value) can match and only if it converts back to value
+        template <typename T, typename U> constexpr bool narrow(const U &value, T &out) noexcept {
+            if constexpr (::std::is_same<T, U>::value) {
+                out = value;
+                return true;
+            } else {
+                using common_type = ::std::common_type_t<T, U>;
+                out               = T(value);
+                return common_type(out) == common_type(value);
+            }
+        }
+
+        // the index of the first element equal to value, count if there isn't one
+        template <kernel_type T> constexpr size_t find(const T *first, size_t count, T value) noexcept {
+#if STACK_VECTOR_SIMD_X86
+            if (!::std::is_constant_evaluated()) {
+                if (active_isa == isa_level::_avx2)
+                    return details::find_avx2(first, count, value);
+                if (active_isa == isa_level::_sse2)
+                    return details::find_sse2(first, count, value);
+            }
+#endif
+            return details::find_scalar(first, count, value);
+        }
+
+        template <kernel_type T> constexpr size_t count(const T *first, size_t count, T value) noexcept {
+#if STACK_VECTOR_SIMD_X86
+            if (!::std::is_constant_evaluated()) {
+                if (active_isa == isa_level::_avx2)
+                    return details::count_avx2(first, count, value);
+                if (active_isa == isa_level::_sse2)
+                    return details::count_sse2(first, count, value);
+            }
+#endif
+            return details::count_scalar(first, count, value);
+        }
+
+        // how many elements are less than value, on sorted elements that's the lower bound
+        template <kernel_type T> constexpr size_t count_less(const T *first, size_t count, T value) noexcept {
+#if STACK_VECTOR_SIMD_X86
+            if (!::std::is_constant_evaluated()) {
+                if (active_isa == isa_level::_avx2)
+                    return details::count_less_avx2(first, count, value);
+                if constexpr (details::has_less_sse2<T>) {
+                    if (active_isa == isa_level::_sse2)
+                        return details::count_less_sse2(first, count, value);
+                }
+            }
+#endif
+            return details::count_less_scalar(first, count, value);
+        }
+
+        // moves the elements not equal to value to the front, in order, returns how many there are
+        template <kernel_type T> constexpr size_t remove(T *first, size_t count, T value) noexcept {
+#if STACK_VECTOR_SIMD_X86
+            if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+                if (!::std::is_constant_evaluated() && active_isa == isa_level::_avx2)
+                    return details::remove_avx2(first, count, value);
+            }
+#endif
+            return details::remove_scalar(first, count, value);
+        }
+
+        // as remove, for the elements pred rejects, pred sees every element exactly once
+        template <kernel_type T, typename Pred> constexpr size_t remove_if(T *first, size_t count, Pred &pred) {
+            return details::remove_if_scalar(first, count, pred);
+        }
+    } // namespace simd
+} // namespace stack_vector
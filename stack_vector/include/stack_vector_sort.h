@@ -0,0 +1,569 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// up to this many small trivially copyable T's are sorted by a sorting network (at most 64)
+#ifndef STACK_VECTOR_SORT_NETWORK_MAX
+#define STACK_VECTOR_SORT_NETWORK_MAX 32
+#endif
+
+// networks up to this size are unrolled into straight line code, one function per size, larger ones loop
+// over a table of comparators. Unrolled is 2-3x faster but all 32 sizes would be ~56KB of code per T.
+#ifndef STACK_VECTOR_SORT_UNROLL_MAX
+#define STACK_VECTOR_SORT_UNROLL_MAX 16
+#endif
+
+// up to this many of any other T are insertion sorted, above it (and above the network size) pdqsort
+// takes over, finishing its own small partitions the same way
+#ifndef STACK_VECTOR_SORT_INSERTION_MAX
+#define STACK_VECTOR_SORT_INSERTION_MAX 24
+#endif
+
+#ifndef STACK_VECTOR_FORCEINLINE
+#if defined(_MSC_VER)
+#define STACK_VECTOR_FORCEINLINE __forceinline
+#else
+#define STACK_VECTOR_FORCEINLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace stack_vector {
+    namespace sorting {
+        // T's cheap enough to copy that a network's unconditional compare-exchanges beat moving fewer of
+        // them around
+        template <typename T>
+        concept network_type = ::std::is_trivially_copyable<T>::value && sizeof(T) <= 16;
+
+        namespace details {
+            static_assert(STACK_VECTOR_SORT_NETWORK_MAX >= 2 && STACK_VECTOR_SORT_NETWORK_MAX <= 64,
+                          "sorting networks cover 2 to 64 elements");
+            constexpr size_t network_max = STACK_VECTOR_SORT_NETWORK_MAX;
+
+            // the compare-exchanges of Batcher's odd-even merge sort for n elements: the network for the
+            // next power of two with every comparator touching an index past n dropped, those elements
+            // would have been +infinity and never move
+            template <typename Add> constexpr void batcher_pairs(size_t n, Add &&add) {
+                const size_t width = ::std::bit_ceil(n);
+                for (size_t p = 1; p < width; p *= 2) {
+                    for (size_t k = p; k >= 1; k /= 2) {
+                        for (size_t j = k % p; j + k < width; j += 2 * k) {
+                            for (size_t i = 0; i < k && i + j + k < width; i++) {
+                                if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n)
+                                    add(i + j, i + j + k);
+                            }
+                        }
+                    }
+                }
+            }
+            constexpr size_t network_pair_total() {
+                size_t total = 0;
+                for (size_t n = 2; n <= network_max; n++)
+                    batcher_pairs(n, [&total](size_t, size_t) { total++; });
+                return total;
+            }
+
+            // every network from 2 to network_max elements, pairs[start[n], start[n + 1]) sorts n
+            struct network_table {
+                uint16_t start[network_max + 2] = {};
+                uint8_t  pairs[network_pair_total()][2] = {};
+            };
+            constexpr network_table make_network_table() {
+                network_table table;
+                size_t        count = 0;
+                for (size_t n = 0; n <= network_max; n++) {
+                    table.start[n] = uint16_t(count);
+                    if (n >= 2) {
+                        batcher_pairs(n, [&table, &count](size_t i, size_t j) {
+                            table.pairs[count][0] = uint8_t(i);
+                            table.pairs[count][1] = uint8_t(j);
+                            count++;
+                        });
+                    }
+                }
+                table.start[network_max + 1] = uint16_t(count);
+                return table;
+            }
+            inline constexpr network_table networks = make_network_table();
+
+            // the smaller of a and b into a, without a branch, arithmetic T's compile down to min / max or
+            // conditional moves
+            template <typename T, typename Compare>
+            STACK_VECTOR_FORCEINLINE constexpr void compare_exchange(T &a, T &b, Compare &comp) {
+                const bool swap = comp(b, a);
+                const T    lo   = swap ? b : a;
+                const T    hi   = swap ? a : b;
+                a               = lo;
+                b               = hi;
+            }
+            template <size_t Count, typename T, typename Compare, size_t... I>
+            STACK_VECTOR_FORCEINLINE constexpr void unrolled_network([[maybe_unused]] T       *first,
+                                                                     [[maybe_unused]] Compare &comp,
+                                                                     ::std::index_sequence<I...>) {
+                constexpr auto *pairs = networks.pairs + networks.start[Count];
+                (compare_exchange(first[pairs[I][0]], first[pairs[I][1]], comp), ...);
+            }
+            template <size_t Count, typename T, typename Compare>
+            constexpr void unrolled_network_sort(T *first, Compare &comp) {
+                constexpr size_t pair_count = networks.start[Count + 1] - networks.start[Count];
+                unrolled_network<Count>(first, comp, ::std::make_index_sequence<pair_count>{});
+            }
+            template <typename T, typename Compare, size_t... Count>
+            constexpr auto make_unrolled_networks(::std::index_sequence<Count...>) {
+                return ::std::array<void (*)(T *, Compare &), sizeof...(Count)>{
+                    &unrolled_network_sort<Count, T, Compare>...};
+            }
+            template <typename T, typename Compare, size_t Max>
+            inline constexpr auto unrolled_networks = make_unrolled_networks<T, Compare>(
+                ::std::make_index_sequence<::std::min<size_t>(Max, STACK_VECTOR_SORT_UNROLL_MAX) + 1>{});
+
+            // sorts count <= Max elements, Max being the capacity when it's known to be smaller, so the
+            // unrolled networks for sizes that can't happen aren't instantiated
+            template <size_t Max = network_max, typename T, typename Compare>
+            constexpr void network_sort(T *first, size_t count, Compare &comp) {
+                constexpr auto &unrolled = unrolled_networks<T, Compare, Max>;
+                if (count < unrolled.size()) {
+                    unrolled[count](first, comp);
+                    return;
+                }
+                for (size_t k = networks.start[count]; k < networks.start[count + 1]; k++)
+                    compare_exchange(first[networks.pairs[k][0]], first[networks.pairs[k][1]], comp);
+            }
+
+            template <typename T, typename Compare>
+            constexpr void insertion_sort(T *first, T *last, Compare &comp) {
+                if (first == last)
+                    return;
+                for (T *cur = first + 1; cur != last; ++cur) {
+                    T *sift = cur;
+                    if (comp(*sift, *(sift - 1))) {
+                        T tmp = ::std::move(*sift);
+                        do {
+                            *sift = ::std::move(*(sift - 1));
+                            --sift;
+                        } while (sift != first && comp(tmp, *(sift - 1)));
+                        *sift = ::std::move(tmp);
+                    }
+                }
+            }
+            // as insertion_sort, when an element before first is known to be no greater than any in range
+            template <typename T, typename Compare>
+            constexpr void unguarded_insertion_sort(T *first, T *last, Compare &comp) {
+                if (first == last)
+                    return;
+                for (T *cur = first + 1; cur != last; ++cur) {
+                    T *sift = cur;
+                    if (comp(*sift, *(sift - 1))) {
+                        T tmp = ::std::move(*sift);
+                        do {
+                            *sift = ::std::move(*(sift - 1));
+                            --sift;
+                        } while (comp(tmp, *(sift - 1)));
+                        *sift = ::std::move(tmp);
+                    }
+                }
+            }
+            // insertion sorts as long as few elements have to move, false if it gave up (a partition that
+            // was nearly sorted to begin with is finished here)
+            template <typename T, typename Compare>
+            constexpr bool partial_insertion_sort(T *first, T *last, Compare &comp) {
+                if (first == last)
+                    return true;
+                size_t moved = 0;
+                for (T *cur = first + 1; cur != last; ++cur) {
+                    T *sift = cur;
+                    if (comp(*sift, *(sift - 1))) {
+                        T tmp = ::std::move(*sift);
+                        do {
+                            *sift = ::std::move(*(sift - 1));
+                            --sift;
+                        } while (sift != first && comp(tmp, *(sift - 1)));
+                        *sift = ::std::move(tmp);
+                        moved += size_t(cur - sift);
+                    }
+                    if (moved > 8)
+                        return false;
+                }
+                return true;
+            }
+
+            // the partitions pdqsort and select leave behind are finished here
+            template <typename T>
+            constexpr size_t small_sort_max =
+                network_type<T> ? network_max : size_t(STACK_VECTOR_SORT_INSERTION_MAX);
+            template <size_t Max = network_max, typename T, typename Compare>
+            constexpr void small_sort(T *first, T *last, Compare &comp, bool leftmost) {
+                if constexpr (network_type<T>) {
+                    network_sort<Max>(first, size_t(last - first), comp);
+                } else {
+                    if (leftmost)
+                        insertion_sort(first, last, comp);
+                    else
+                        unguarded_insertion_sort(first, last, comp);
+                }
+            }
+
+            template <typename T, typename Compare> constexpr void sort3(T *a, T *b, T *c, Compare &comp) {
+                if (comp(*b, *a))
+                    ::std::iter_swap(a, b);
+                if (comp(*c, *b))
+                    ::std::iter_swap(b, c);
+                if (comp(*b, *a))
+                    ::std::iter_swap(a, b);
+            }
+            // the median of three (or of three medians of three on larger ranges) moved to first
+            template <typename T, typename Compare>
+            constexpr void choose_pivot(T *first, T *last, Compare &comp) {
+                const size_t size = size_t(last - first);
+                const size_t half = size / 2;
+                if (size > 128) {
+                    sort3(first, first + half, last - 1, comp);
+                    sort3(first + 1, first + (half - 1), last - 2, comp);
+                    sort3(first + 2, first + (half + 1), last - 3, comp);
+                    sort3(first + (half - 1), first + half, first + (half + 1), comp);
+                    ::std::iter_swap(first, first + half);
+                } else {
+                    sort3(first + half, first, last - 1, comp);
+                }
+            }
+
+            // partitions around the pivot at first, elements equal to it go right. Returns where the pivot
+            // ends up, and whether nothing had to be swapped.
+            template <typename T, typename Compare>
+            constexpr ::std::pair<T *, bool> partition_right(T *first_, T *last_, Compare &comp) {
+                T  pivot = ::std::move(*first_);
+                T *first = first_;
+                T *last  = last_;
+                while (comp(*++first, pivot)) {
+                }
+                if (first - 1 == first_) {
+                    while (first < last && !comp(*--last, pivot)) {
+                    }
+                } else {
+                    while (!comp(*--last, pivot)) {
+                    }
+                }
+                const bool already_partitioned = first >= last;
+                while (first < last) {
+                    ::std::iter_swap(first, last);
+                    while (comp(*++first, pivot)) {
+                    }
+                    while (!comp(*--last, pivot)) {
+                    }
+                }
+                T *pivot_pos = first - 1;
+                *first_      = ::std::move(*pivot_pos);
+                *pivot_pos   = ::std::move(pivot);
+                return {pivot_pos, already_partitioned};
+            }
+
+            // partition_right without branching on the comparisons: a block of elements on each side is
+            // compared first and the offsets of the ones on the wrong side recorded, then they're swapped
+            // in pairs (BlockQuicksort, Edelkamp and Weiss)
+            constexpr size_t block_size = 64;
+            template <typename T>
+            STACK_VECTOR_FORCEINLINE void swap_offsets(T *first, T *last, const unsigned char *offsets_l,
+                                                       const unsigned char *offsets_r, size_t count,
+                                                       bool use_swaps) {
+                if (use_swaps) {
+                    // pairwise swaps, or the cycle below would move an element onto itself
+                    for (size_t i = 0; i < count; i++)
+                        ::std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+                } else if (count) {
+                    T *l   = first + offsets_l[0];
+                    T *r   = last - offsets_r[0];
+                    T  tmp = ::std::move(*l);
+                    *l     = ::std::move(*r);
+                    for (size_t i = 1; i < count; i++) {
+                        l  = first + offsets_l[i];
+                        *r = ::std::move(*l);
+                        r  = last - offsets_r[i];
+                        *l = ::std::move(*r);
+                    }
+                    *r = ::std::move(tmp);
+                }
+            }
+            template <typename T, typename Compare>
+            ::std::pair<T *, bool> partition_right_branchless(T *first_, T *last_, Compare &comp) {
+                T  pivot = ::std::move(*first_);
+                T *first = first_;
+                T *last  = last_;
+                while (comp(*++first, pivot)) {
+                }
+                if (first - 1 == first_) {
+                    while (first < last && !comp(*--last, pivot)) {
+                    }
+                } else {
+                    while (!comp(*--last, pivot)) {
+                    }
+                }
+                const bool already_partitioned = first >= last;
+                if (!already_partitioned) {
+                    ::std::iter_swap(first, last);
+                    ++first;
+
+                    alignas(64) unsigned char offsets_l[block_size];
+                    alignas(64) unsigned char offsets_r[block_size];
+                    T                        *offsets_l_base = first;
+                    T                        *offsets_r_base = last;
+                    size_t                    num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+                    while (first < last) {
+                        // fill whichever blocks are empty, splitting what's left between them near the end
+                        const size_t unknown     = size_t(last - first);
+                        const size_t left_split  = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+                        const size_t right_split = num_r == 0 ? (unknown - left_split) : 0;
+                        const size_t left_count  = ::std::min(left_split, block_size);
+                        const size_t right_count = ::std::min(right_split, block_size);
+                        for (size_t i = 0; i < left_count; i++) {
+                            offsets_l[num_l] = (unsigned char)i;
+                            num_l += !comp(*first, pivot);
+                            ++first;
+                        }
+                        for (size_t i = 0; i < right_count; i++) {
+                            offsets_r[num_r] = (unsigned char)(i + 1);
+                            num_r += comp(*--last, pivot);
+                        }
+
+                        const size_t count = ::std::min(num_l, num_r);
+                        swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r,
+                                     count, num_l == num_r);
+                        num_l -= count;
+                        num_r -= count;
+                        start_l += count;
+                        start_r += count;
+                        if (num_l == 0) {
+                            start_l        = 0;
+                            offsets_l_base = first;
+                        }
+                        if (num_r == 0) {
+                            start_r        = 0;
+                            offsets_r_base = last;
+                        }
+                    }
+                    // one block may still hold misplaced elements, move them next to the boundary
+                    if (num_l) {
+                        while (num_l--)
+                            ::std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+                        first = last;
+                    }
+                    if (num_r) {
+                        while (num_r--) {
+                            ::std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                            ++first;
+                        }
+                    }
+                }
+                T *pivot_pos = first - 1;
+                *first_      = ::std::move(*pivot_pos);
+                *pivot_pos   = ::std::move(pivot);
+                return {pivot_pos, already_partitioned};
+            }
+
+            // partitions around the pivot at first, elements equal to it go left, only used when every
+            // element is known to be no less than the pivot, so the equal ones are done with
+            template <typename T, typename Compare>
+            constexpr T *partition_left(T *first_, T *last_, Compare &comp) {
+                T  pivot = ::std::move(*first_);
+                T *first = first_;
+                T *last  = last_;
+                while (comp(pivot, *--last)) {
+                }
+                if (last + 1 == last_) {
+                    while (first < last && !comp(pivot, *++first)) {
+                    }
+                } else {
+                    while (!comp(pivot, *++first)) {
+                    }
+                }
+                while (first < last) {
+                    ::std::iter_swap(first, last);
+                    while (comp(pivot, *--last)) {
+                    }
+                    while (!comp(pivot, *++first)) {
+                    }
+                }
+                T *pivot_pos = last;
+                *first_      = ::std::move(*pivot_pos);
+                *pivot_pos   = ::std::move(pivot);
+                return pivot_pos;
+            }
+
+            // comparisons that can be evaluated without a branch and don't depend on anything but the values
+            template <typename T, typename Compare>
+            constexpr bool branchless_compare =
+                ::std::is_arithmetic<T>::value &&
+                (::std::is_same<Compare, ::std::less<>>::value ||
+                 ::std::is_same<Compare, ::std::less<T>>::value ||
+                 ::std::is_same<Compare, ::std::greater<>>::value ||
+                 ::std::is_same<Compare, ::std::greater<T>>::value);
+
+            template <typename T, typename Compare>
+            constexpr ::std::pair<T *, bool> partition(T *first, T *last, Compare &comp) {
+                if constexpr (branchless_compare<T, Compare>) {
+                    if (!::std::is_constant_evaluated())
+                        return partition_right_branchless(first, last, comp);
+                }
+                return partition_right(first, last, comp);
+            }
+
+            // shuffles a few elements around after a lopsided partition, breaking up patterns that would
+            // keep picking bad pivots
+            template <typename T> constexpr void break_patterns(T *first, T *pivot_pos, T *last) {
+                const size_t l_size = size_t(pivot_pos - first);
+                const size_t r_size = size_t(last - (pivot_pos + 1));
+                if (l_size >= STACK_VECTOR_SORT_INSERTION_MAX) {
+                    ::std::iter_swap(first, first + l_size / 4);
+                    ::std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > 128) {
+                        ::std::iter_swap(first + 1, first + (l_size / 4 + 1));
+                        ::std::iter_swap(first + 2, first + (l_size / 4 + 2));
+                        ::std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        ::std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= STACK_VECTOR_SORT_INSERTION_MAX) {
+                    ::std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    ::std::iter_swap(last - 1, last - r_size / 4);
+                    if (r_size > 128) {
+                        ::std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        ::std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        ::std::iter_swap(last - 2, last - (1 + r_size / 4));
+                        ::std::iter_swap(last - 3, last - (2 + r_size / 4));
+                    }
+                }
+            }
+
+            // pattern-defeating quicksort (Orson Peters): median of three pivots, already partitioned
+            // ranges finished by insertion sort, runs of equal elements split off in one pass and a
+            // heapsort once too many partitions came out lopsided
+            template <typename T, typename Compare>
+            constexpr void pdqsort_loop(T *first, T *last, Compare &comp, int bad_allowed, bool leftmost) {
+                while (true) {
+                    const size_t size = size_t(last - first);
+                    if (size <= small_sort_max<T>) {
+                        small_sort(first, last, comp, leftmost);
+                        return;
+                    }
+                    choose_pivot(first, last, comp);
+                    // the element before first is a previous pivot, if it's equal to this one then so is
+                    // everything partition_left puts on its left
+                    if (!leftmost && !comp(*(first - 1), *first)) {
+                        first = partition_left(first, last, comp) + 1;
+                        continue;
+                    }
+                    const auto [pivot_pos, already_partitioned] = partition(first, last, comp);
+                    const size_t l_size = size_t(pivot_pos - first);
+                    const size_t r_size = size_t(last - (pivot_pos + 1));
+                    if (l_size < size / 8 || r_size < size / 8) {
+                        if (--bad_allowed == 0) {
+                            ::std::make_heap(first, last, comp);
+                            ::std::sort_heap(first, last, comp);
+                            return;
+                        }
+                        break_patterns(first, pivot_pos, last);
+                    } else if (already_partitioned && partial_insertion_sort(first, pivot_pos, comp) &&
+                               partial_insertion_sort(pivot_pos + 1, last, comp)) {
+                        return;
+                    }
+                    pdqsort_loop(first, pivot_pos, comp, bad_allowed, leftmost);
+                    first    = pivot_pos + 1;
+                    leftmost = false;
+                }
+            }
+
+            // quickselect on the same partitions, once nth is in a small enough range that range is sorted
+            template <typename T, typename Compare>
+            constexpr void select(T *first, T *nth, T *last, Compare &comp, int bad_allowed) {
+                while (size_t(last - first) > small_sort_max<T>) {
+                    const size_t size = size_t(last - first);
+                    choose_pivot(first, last, comp);
+                    const T     *pivot_pos = partition(first, last, comp).first;
+                    const size_t l_size    = size_t(pivot_pos - first);
+                    const size_t r_size    = size_t(last - (pivot_pos + 1));
+                    if ((l_size < size / 8 || r_size < size / 8) && --bad_allowed == 0) {
+                        ::std::nth_element(first, nth, last, comp);
+                        return;
+                    }
+                    if (nth == pivot_pos)
+                        return;
+                    if (nth < pivot_pos)
+                        last = first + l_size;
+                    else
+                        first = first + l_size + 1;
+                }
+                small_sort(first, last, comp, true);
+            }
+
+            constexpr int log2(size_t n) noexcept {
+                return int(::std::bit_width(n));
+            }
+        } // namespace details
+
+        // sorts [first, first + count) by comp: a sorting network for small trivially copyable T's, insertion
+        // sort for other small ranges and pdqsort for everything else, not stable
+        template <typename T, typename Compare> constexpr void sort(T *first, size_t count, Compare comp) {
+            if (count <= details::small_sort_max<T>) {
+                details::small_sort(first, first + count, comp, true);
+                return;
+            }
+            details::pdqsort_loop(first, first + count, comp, details::log2(count), true);
+        }
+
+        // puts the element that would be at nth after sorting there, with nothing greater before it and
+        // nothing less after it
+        template <typename T, typename Compare>
+        constexpr void nth_element(T *first, size_t nth, size_t count, Compare comp) {
+            if (nth >= count)
+                return;
+            details::select(first, first + nth, first + count, comp, details::log2(count));
+        }
+
+        // the middle smallest elements, sorted, at the front, the rest in no particular order
+        template <typename T, typename Compare>
+        constexpr void partial_sort(T *first, size_t middle, size_t count, Compare comp) {
+            // a network sorts everything about as fast as it could select
+            if (count <= details::small_sort_max<T> || middle >= count) {
+                ::stack_vector::sorting::sort(first, count, comp);
+                return;
+            }
+            if (!middle)
+                return;
+            // for a few out of many, one pass keeping a heap of the best so far beats partitioning
+            if (middle * 16 <= count) {
+                ::std::partial_sort(first, first + middle, first + count, comp);
+                return;
+            }
+            details::select(first, first + middle, first + count, comp, details::log2(count));
+            ::stack_vector::sorting::sort(first, middle, comp);
+        }
+    } // namespace sorting
+} // namespace stack_vector
@@ -0,0 +1,284 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Alex Anderson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// 1 to count, for every stack_vector<T, N>, its peak size, its sizes at destruction and the inserts that
+// didn't fit. Off (0) nothing is recorded and stack_vector is unchanged, the reports are just empty.
+#ifndef STACK_VECTOR_TELEMETRY
+#define STACK_VECTOR_TELEMETRY 0
+#endif
+
+// how many even slices of [0, N] the sizes at destruction are counted in
+#ifndef STACK_VECTOR_TELEMETRY_BUCKETS
+#define STACK_VECTOR_TELEMETRY_BUCKETS 16
+#endif
+
+#ifndef STACK_VECTOR_FORCEINLINE
+#if defined(_MSC_VER)
+#define STACK_VECTOR_FORCEINLINE __forceinline
+#else
+#define STACK_VECTOR_FORCEINLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace stack_vector {
+    namespace telemetry {
+        constexpr bool   enabled = STACK_VECTOR_TELEMETRY != 0;
+        constexpr size_t buckets = STACK_VECTOR_TELEMETRY_BUCKETS;
+
+        // one stack_vector<T, N>'s counters as of a snapshot
+        struct statistics {
+            ::std::string                   type;      // T
+            size_t                          capacity;  // N
+            uint64_t                        peak;      // the largest size any of them reached
+            uint64_t                        destroyed; // how many were destroyed
+            uint64_t                        overflows; // inserts, appends and resizes that didn't fit
+            ::std::array<uint64_t, buckets> sizes;     // sizes at destruction, see bucket_range
+
+            // the sizes counted in bucket i, inclusive
+            [[nodiscard]] constexpr ::std::pair<size_t, size_t> bucket_range(size_t i) const noexcept {
+                // a size s lands in bucket s * buckets / (N + 1)
+                const size_t first = (i * (capacity + 1) + buckets - 1) / buckets;
+                const size_t last  = ((i + 1) * (capacity + 1) + buckets - 1) / buckets;
+                return {first, last - 1};
+            }
+        };
+
+        namespace details {
+            // T's name, cut out of the signature of a function templated on it
+            template <typename T> constexpr ::std::string_view type_name() noexcept {
+#if defined(_MSC_VER)
+                const ::std::string_view signature = __FUNCSIG__;
+                const size_t             first     = signature.find("type_name<") + 10;
+                const size_t             last      = signature.rfind(">(void)");
+#else
+                const ::std::string_view signature = __PRETTY_FUNCTION__;
+                const size_t             first     = signature.find("T = ") + 4;
+                size_t                   last      = signature.find(';', first);
+                if (last == ::std::string_view::npos)
+                    last = signature.rfind(']');
+#endif
+                return signature.substr(first, last - first);
+            }
+
+            // the live counters of one stack_vector<T, N>, linked into a list of all of them as it's first
+            // used. Relaxed atomics, stack_vectors on any thread count into the same ones.
+            struct counters {
+                ::std::string_view                             type;
+                size_t                                         capacity;
+                ::std::atomic<uint64_t>                        peak      = 0;
+                ::std::atomic<uint64_t>                        destroyed = 0;
+                ::std::atomic<uint64_t>                        overflows = 0;
+                ::std::array<::std::atomic<uint64_t>, buckets> sizes     = {};
+                counters                                      *next      = nullptr;
+
+                counters(::std::string_view type_, size_t capacity_) noexcept;
+
+                void grew(uint64_t size) noexcept {
+                    uint64_t known = peak.load(::std::memory_order_relaxed);
+                    while (size > known &&
+                           !peak.compare_exchange_weak(known, size, ::std::memory_order_relaxed)) {
+                    }
+                }
+                void destroy(uint64_t size) noexcept {
+                    destroyed.fetch_add(1, ::std::memory_order_relaxed);
+                    sizes[size * buckets / (capacity + 1)].fetch_add(1, ::std::memory_order_relaxed);
+                }
+            };
+
+            inline ::std::atomic<counters *> registry = nullptr;
+
+            inline counters::counters(::std::string_view type_, size_t capacity_) noexcept
+                : type(type_), capacity(capacity_) {
+                next = registry.load(::std::memory_order_relaxed);
+                while (!registry.compare_exchange_weak(next, this, ::std::memory_order_release,
+                                                       ::std::memory_order_relaxed)) {
+                }
+            }
+
+            template <typename T, size_t N> counters &counters_for() noexcept {
+                static counters instance(type_name<T>(), N);
+                return instance;
+            }
+
+            // an insert, append or resize that didn't fit
+            template <typename T, size_t N> STACK_VECTOR_FORCEINLINE constexpr void overflowed() noexcept {
+                if constexpr (enabled) {
+                    if (!::std::is_constant_evaluated())
+                        counters_for<T, N>().overflows.fetch_add(1, ::std::memory_order_relaxed);
+                }
+            }
+
+            // stands in for stack_vector's size counter when telemetry is on, every write that grows it
+            // checks the peak and its destructor counts the final size. Same size as the counter, but no
+            // longer trivially destructible, so neither are the stack_vectors.
+            template <typename Int, typename T, size_t N> struct tracked_size {
+                Int value = 0;
+
+                constexpr tracked_size() noexcept = default;
+                constexpr tracked_size(const tracked_size &) noexcept = default;
+                constexpr tracked_size &operator=(const tracked_size &other) noexcept {
+                    return *this = size_t(other.value);
+                }
+                constexpr ~tracked_size() {
+                    if (!::std::is_constant_evaluated())
+                        counters_for<T, N>().destroy(value);
+                }
+
+                constexpr operator Int() const noexcept {
+                    return value;
+                }
+                constexpr tracked_size &operator=(size_t size) noexcept {
+                    const bool grows = size > value;
+                    value            = Int(size);
+                    if (grows && !::std::is_constant_evaluated())
+                        counters_for<T, N>().grew(value);
+                    return *this;
+                }
+                constexpr tracked_size &operator+=(size_t count) noexcept {
+                    return *this = size_t(value) + count;
+                }
+                constexpr tracked_size &operator-=(size_t count) noexcept {
+                    value = Int(value - count);
+                    return *this;
+                }
+                // exchanges the raw counts, both are already within the peak and no temporary is destroyed
+                friend constexpr void swap(tracked_size &left, tracked_size &right) noexcept {
+                    const Int tmp = left.value;
+                    left.value    = right.value;
+                    right.value   = tmp;
+                }
+            };
+
+            inline void append_json_string(::std::string &out, ::std::string_view text) {
+                out += '"';
+                for (char c : text) {
+                    if (c == '"' || c == '\\')
+                        out += '\\';
+                    out += c;
+                }
+                out += '"';
+            }
+        } // namespace details
+
+        // every stack_vector<T, N> used so far (with telemetry on)
+        inline ::std::vector<statistics> snapshot() {
+            ::std::vector<statistics> ret;
+            for (auto *c = details::registry.load(::std::memory_order_acquire); c; c = c->next) {
+                statistics stats;
+                stats.type      = ::std::string(c->type);
+                stats.capacity  = c->capacity;
+                stats.peak      = c->peak.load(::std::memory_order_relaxed);
+                stats.destroyed = c->destroyed.load(::std::memory_order_relaxed);
+                stats.overflows = c->overflows.load(::std::memory_order_relaxed);
+                for (size_t i = 0; i < buckets; i++)
+                    stats.sizes[i] = c->sizes[i].load(::std::memory_order_relaxed);
+                ret.push_back(::std::move(stats));
+            }
+            return ret;
+        }
+
+        // zeroes every counter, e.g. after warming up
+        inline void reset() noexcept {
+            for (auto *c = details::registry.load(::std::memory_order_acquire); c; c = c->next) {
+                c->peak.store(0, ::std::memory_order_relaxed);
+                c->destroyed.store(0, ::std::memory_order_relaxed);
+                c->overflows.store(0, ::std::memory_order_relaxed);
+                for (auto &bucket : c->sizes)
+                    bucket.store(0, ::std::memory_order_relaxed);
+            }
+        }
+
+        // a few lines per stack_vector<T, N>:
+        //     stack_vector<int, 64>: peak 40, 1000 destroyed, 3 overflows
+        //         sizes at destruction: 0-3: 10, 36-39: 990
+        inline ::std::string report_text() {
+            ::std::string out;
+            for (const auto &stats : snapshot()) {
+                out += "stack_vector<" + stats.type + ", " + ::std::to_string(stats.capacity) + ">: peak " +
+                       ::std::to_string(stats.peak) + ", " + ::std::to_string(stats.destroyed) +
+                       " destroyed, " + ::std::to_string(stats.overflows) + " overflows\n";
+                if (!stats.destroyed)
+                    continue;
+                out += "    sizes at destruction:";
+                const char *separator = " ";
+                for (size_t i = 0; i < buckets; i++) {
+                    if (!stats.sizes[i])
+                        continue;
+                    const auto [first, last] = stats.bucket_range(i);
+                    // piece by piece, "literal" + to_string() trips a gcc 12 -Wrestrict false positive
+                    out += separator;
+                    out += ::std::to_string(first);
+                    if (last != first) {
+                        out += '-';
+                        out += ::std::to_string(last);
+                    }
+                    out += ": ";
+                    out += ::std::to_string(stats.sizes[i]);
+                    separator = ", ";
+                }
+                out += "\n";
+            }
+            return out;
+        }
+
+        // the same as a json array, one object per stack_vector<T, N> with the non empty buckets listed as
+        // {"min", "max", "count"}
+        inline ::std::string report_json() {
+            ::std::string out = "[";
+            for (const auto &stats : snapshot()) {
+                if (out.size() > 1)
+                    out += ",";
+                out += "{\"type\":";
+                details::append_json_string(out, stats.type);
+                out += ",\"capacity\":" + ::std::to_string(stats.capacity) +
+                       ",\"peak\":" + ::std::to_string(stats.peak) +
+                       ",\"destroyed\":" + ::std::to_string(stats.destroyed) +
+                       ",\"overflows\":" + ::std::to_string(stats.overflows) + ",\"sizes\":[";
+                const char *separator = "";
+                for (size_t i = 0; i < buckets; i++) {
+                    if (!stats.sizes[i])
+                        continue;
+                    const auto [first, last] = stats.bucket_range(i);
+                    out += separator;
+                    out += "{\"min\":" + ::std::to_string(first) + ",\"max\":" + ::std::to_string(last) +
+                           ",\"count\":" + ::std::to_string(stats.sizes[i]) + "}";
+                    separator = ",";
+                }
+                out += "]}";
+            }
+            return out + "]";
+        }
+    } // namespace telemetry
+} // namespace stack_vector
@@ -0,0 +1,96 @@
+// concurrent_stack_vector_test.cpp : concurrent_stack_vector checks, many producers then one reader
+//
+#include "concurrent_stack_vector.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main() {
+    std::string output = "";
+
+    // every producer's values arrive exactly once, singles and batches mixed
+    constexpr uint32_t threads    = 8;
+    constexpr uint32_t per_thread = 3000;
+    auto test = std::make_unique<stack_vector::concurrent_stack_vector<uint32_t, threads * per_thread>>();
+    std::vector<std::thread> producers;
+    for (uint32_t t = 0; t < threads; t++) {
+        producers.emplace_back([&test, t] {
+            uint32_t batch[10];
+            for (uint32_t i = 0; i < per_thread;) {
+                if (i % 20 == 0) {
+                    for (uint32_t k = 0; k < 10; k++)
+                        batch[k] = t * per_thread + i + k;
+                    i += uint32_t(test->append(std::span<const uint32_t>(batch)));
+                } else {
+                    i += test->shove_back(t * per_thread + i);
+                }
+            }
+        });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    std::span<uint32_t> sealed = test->seal();
+    assert(test->sealed() && sealed.size() == threads * per_thread && test->size() == sealed.size() &&
+           "concurrent_stack_vector lost appends");
+    std::sort(sealed.begin(), sealed.end());
+    for (uint32_t i = 0; i < sealed.size(); i++) {
+        assert(sealed[i] == i && "concurrent_stack_vector duplicated or corrupted an append");
+    }
+    [[maybe_unused]] const auto shoved_sealed = test->shove_back(0);
+    assert(!shoved_sealed && test->size() == threads * per_thread &&
+           "a sealed concurrent_stack_vector takes no appends");
+
+    // overflow keeps what fits, a straddling batch included
+    stack_vector::concurrent_stack_vector<std::string, 4> string_test;
+    [[maybe_unused]] const auto emplaced = string_test.emplace_back("a");
+    [[maybe_unused]] const auto shoved   = string_test.shove_back(std::string("b"));
+    assert(emplaced && shoved && "append failed");
+    const std::string           batch[3]      = {"c", "d", "e"};
+    [[maybe_unused]] const auto appended      = string_test.append(batch, batch + 3);
+    [[maybe_unused]] const auto emplaced_full = string_test.emplace_back("f");
+    assert(appended == 2 && !emplaced_full && string_test.size_approx() == 4 &&
+           "concurrent_stack_vector overflow failed");
+    string_test.seal();
+    assert(string_test.size() == 4 && string_test[0] == "a" && string_test[3] == "d" &&
+           string_test.begin()[2] == "c" && "concurrent_stack_vector contents wrong after overflow");
+
+    // clear reopens it
+    string_test.clear();
+    [[maybe_unused]] const bool reopened = !string_test.sealed();
+    [[maybe_unused]] const auto refilled = string_test.emplace_back("g");
+    [[maybe_unused]] const auto resealed = string_test.seal();
+    assert(reopened && refilled && resealed.size() == 1 && string_test[0] == "g" &&
+           "concurrent_stack_vector clear failed");
+
+    // a range whose iterator throws part way keeps what went in before, and seal() still finishes
+    stack_vector::concurrent_stack_vector<std::string, 8> throw_test;
+    const int                                             numbers[5] = {1, 2, 3, 4, 5};
+    auto to_string = [](int i) {
+        if (i == 4)
+            throw std::runtime_error("to_string");
+        return std::to_string(i);
+    };
+    auto                   strings = std::views::transform(numbers, to_string);
+    [[maybe_unused]] bool threw   = false;
+    try {
+        throw_test.append(strings.begin(), strings.end());
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    throw_test.seal();
+    assert(threw && throw_test.size() == 3 && throw_test[2] == "3" &&
+           "a throwing iterator should leave no claimed slot empty");
+
+    for (const auto &str_val : string_test) {
+        output += str_val + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+// flat_map_test.cpp : stack_flat_map / stack_flat_set checks, both lookup paths
+//
+#include "flat_map.h"
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+
+// pairs of references are random access for the iterator concepts, only input for the legacy tags
+using map_iterator = stack_vector::stack_flat_map<int, std::string, 16>::iterator;
+static_assert(std::random_access_iterator<map_iterator>);
+static_assert(std::is_same<std::iterator_traits<map_iterator>::iterator_category, std::input_iterator_tag>::value);
+
+// the linear count and the halving search must agree with std::lower_bound on every key and gap
+template <typename T> bool lower_bound_test() {
+    T keys[64];
+    for (size_t i = 0; i < 64; i++) {
+        keys[i] = T(i * 3 / 2); // runs of equal keys too, and small enough for int8_t
+    }
+    for (size_t n = 0; n <= 64; n++) {
+        for (size_t probe = 0; probe < 100; probe++) {
+            const T      key      = T(probe);
+            const size_t expected = size_t(std::lower_bound(keys, keys + n, key) - keys);
+            if (stack_vector::details::flat_lower_bound(keys, n, key, std::less<T>()) != expected ||
+                stack_vector::details::flat_lower_bound(keys, n, key, std::less_equal<T>{}) !=
+                    size_t(std::upper_bound(keys, keys + n, key) - keys))
+                return false;
+            if (n <= 32 && stack_vector::simd::count_less(keys, n, key) != expected)
+                return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::string output = "";
+
+    const auto supported = stack_vector::simd::supported_isa();
+    for (auto level : {stack_vector::simd::isa_level::_scalar, stack_vector::simd::isa_level::_sse2,
+                       stack_vector::simd::isa_level::_avx2}) {
+        if (level > supported)
+            continue;
+        stack_vector::simd::active_isa = level;
+        assert(lower_bound_test<int8_t>() && lower_bound_test<uint8_t>() && lower_bound_test<int16_t>() &&
+               lower_bound_test<uint32_t>() && lower_bound_test<int64_t>() && lower_bound_test<uint64_t>() &&
+               lower_bound_test<float>() && lower_bound_test<double>() &&
+               "flat lower bound disagrees with std::lower_bound");
+    }
+    stack_vector::simd::active_isa = supported;
+
+    stack_vector::stack_flat_map<int, std::string, 16> test;
+    assert(test.empty() && test.capacity() == 16 && "default stack_flat_map should be empty");
+    for (int i : {5, 3, 9, 1, 7}) {
+        [[maybe_unused]] const bool inserted = test.try_emplace(i, std::to_string(i)).second;
+        assert(inserted && "stack_flat_map insert failed");
+    }
+    [[maybe_unused]] const bool overwrote = test.try_emplace(3, "x").second;
+    assert(!overwrote && test.at(3) == "3" && "try_emplace must not overwrite");
+    assert(test.size() == 5 && std::is_sorted(test.keys().begin(), test.keys().end()) &&
+           "stack_flat_map keys must stay sorted");
+    assert(test.find(7).value() == "7" && test.find(4) == test.end() && test.contains(9) && !test.contains(10) &&
+           test.count(1) == 1 && "stack_flat_map lookup failed");
+    assert(test.lower_bound(4).key() == 5 && test.upper_bound(5).key() == 7 && test.upper_bound(9) == test.end() &&
+           "stack_flat_map bounds failed");
+    test.upper_bound(7).value() = "9";
+    assert(test.at(9) == "9" && "upper_bound of a mutable stack_flat_map should return an iterator");
+    test[4] = "four";
+    test.insert_or_assign(5, "five");
+    assert(test.size() == 6 && test[4] == "four" && test.at(5) == "five" && "stack_flat_map assignment failed");
+    [[maybe_unused]] const size_t erased      = test.erase(3);
+    [[maybe_unused]] const size_t erased_again = test.erase(3);
+    [[maybe_unused]] const int    next_key     = test.erase(test.begin())->first;
+    assert(erased == 1 && erased_again == 0 && next_key == 4 && test.size() == 4 &&
+           "stack_flat_map erase failed");
+    for (auto [key, value] : test) {
+        value += "!";
+    }
+    assert(test.at(9) == "9!" && (*test.rbegin()).first == 9 && test.begin()->second == "four!" &&
+           "stack_flat_map iteration failed");
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        (void)test.at(100);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw && "stack_flat_map at should throw on a missing key");
+
+    // bulk construction sorts once and keeps the first of equal keys
+    stack_vector::stack_flat_map<int, int, 8> bulk_test = {{4, 0}, {2, 0}, {4, 1}, {1, 0}, {2, 1}};
+    assert(bulk_test.size() == 3 && bulk_test.keys()[0] == 1 && bulk_test.at(2) == 0 && bulk_test.at(4) == 0 &&
+           "stack_flat_map bulk construction failed");
+    bulk_test.insert({{3, 3}, {1, 1}, {8, 8}});
+    assert(bulk_test.size() == 5 && bulk_test.at(1) == 0 && bulk_test.at(8) == 8 &&
+           "stack_flat_map bulk insert failed");
+
+    // checked against std::map with random traffic, crossing the linear search threshold
+    stack_vector::stack_flat_map<uint32_t, uint32_t, 128> random_test;
+    std::map<uint32_t, uint32_t>                          reference;
+    std::mt19937                                          gen(7);
+    for (int i = 0; i < 4000; i++) {
+        const uint32_t key = gen() % 200;
+        if (gen() % 3 == 0) {
+            [[maybe_unused]] const size_t erased_count    = random_test.erase(key);
+            [[maybe_unused]] const size_t reference_count = reference.erase(key);
+            assert(erased_count == reference_count && "stack_flat_map erase disagrees");
+        } else if (!random_test.full()) {
+            [[maybe_unused]] const bool inserted = random_test.try_emplace(key, uint32_t(i)).second;
+            [[maybe_unused]] const bool expected = reference.try_emplace(key, uint32_t(i)).second;
+            assert(inserted == expected && "stack_flat_map insert disagrees");
+        }
+        const uint32_t probe = gen() % 200;
+        [[maybe_unused]] auto it    = random_test.find(probe);
+        [[maybe_unused]] auto ref   = reference.find(probe);
+        assert((it == random_test.end()) == (ref == reference.end()) &&
+               (it == random_test.end() || it->second == ref->second) && "stack_flat_map find disagrees");
+    }
+    assert(random_test.size() == reference.size() &&
+           std::equal(random_test.keys().begin(), random_test.keys().end(), reference.begin(), reference.end(),
+                      [](uint32_t key, const auto &pair) { return key == pair.first; }) &&
+           "stack_flat_map keys disagree with std::map");
+
+    // heterogeneous lookup through a transparent compare
+    stack_vector::stack_flat_map<std::string, int, 4, std::less<>> string_test;
+    string_test.emplace("b", 2);
+    string_test.emplace("a", 1);
+    assert(string_test.contains(std::string_view("a")) && string_test.find("b")->second == 2 &&
+           "stack_flat_map transparent lookup failed");
+
+    // keys the compare doesn't take directly go through the key type, like std::map
+    [[maybe_unused]] stack_vector::stack_flat_map<long, int, 8> long_test = {{3, 3}, {1, 1}};
+    stack_vector::stack_flat_map<std::string, int, 4>            plain_string_test;
+    plain_string_test.emplace("abc", 1);
+    assert(long_test.contains(3) && long_test.find(1)->second == 1 && long_test.count(2) == 0 &&
+           long_test.lower_bound(2).key() == 3 && plain_string_test.contains("abc") &&
+           plain_string_test.find("abc") != plain_string_test.end() && "stack_flat_map K lookup failed");
+
+    // keys a full map already holds aren't inserts, repeats among the new ones only count once
+    stack_vector::stack_flat_map<int, int, 4> full_map = {{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    full_map.insert({{2, 20}, {4, 40}});
+    stack_vector::stack_flat_map<int, int, 4> repeat_map = {{1, 1}};
+    repeat_map.insert({{5, 5}, {5, 50}, {5, 51}, {5, 52}, {6, 6}, {7, 7}});
+    assert(full_map.size() == 4 && full_map.at(2) == 2 && full_map.at(4) == 4 && repeat_map.size() == 4 &&
+           repeat_map.at(5) == 5 && repeat_map.at(7) == 7 &&
+           "stack_flat_map bulk insert into a full map failed");
+    // a new key through operator[] on a full map is dropped, not written past the end
+    full_map[9] = 9;
+    assert(full_map.size() == 4 && !full_map.contains(9) && full_map[1] == 1 && "operator[] on a full map");
+
+    stack_vector::stack_flat_set<int, 8> set_test = {5, 1, 5, 3};
+    assert(set_test.size() == 3 && *set_test.begin() == 1 && set_test.contains(5) && !set_test.contains(2) &&
+           "stack_flat_set bulk construction failed");
+    [[maybe_unused]] const bool set_inserted       = set_test.insert(2).second;
+    [[maybe_unused]] const bool set_inserted_again = set_test.insert(2).second;
+    assert(set_inserted && !set_inserted_again && *set_test.lower_bound(4) == 5 &&
+           set_test.upper_bound(5) == set_test.end() && "stack_flat_set insert failed");
+    [[maybe_unused]] const size_t set_erased = set_test.erase(1);
+    [[maybe_unused]] const int    set_next   = *set_test.erase(set_test.begin());
+    assert(set_erased == 1 && set_next == 3 && set_test.size() == 2 && "stack_flat_set erase failed");
+
+    stack_vector::stack_flat_set<int, 2> full_test = {1, 2};
+    [[maybe_unused]] const bool          full_inserted = full_test.insert(3).second;
+    full_test.insert({2, 1, 2});
+    assert(full_test.full() && !full_inserted && full_test.size() == 2 &&
+           "a full stack_flat_set should reject inserts");
+    output += std::to_string(set_test.size()) + " " + std::to_string(full_test.size()) + "\n";
+
+    for (auto [key, value] : test) {
+        output += std::to_string(key) + " " + value + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+// rope_parallel_test.cpp : parallel block_rope building and the parallel segment algorithms
+//
+#include "rope_parallel.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+int main() {
+    std::string output = "";
+
+    // splice_back moves whole blocks when the boundary lines up, elements otherwise
+    rope::block_rope<int, 4> splice_test;
+    rope::block_rope<int, 4> splice_part;
+    for (int i = 0; i < 8; i++) {
+        splice_test.push_back(i);
+    }
+    for (int i = 8; i < 14; i++) {
+        splice_part.push_back(i);
+    }
+    [[maybe_unused]] const int *moved_block = splice_part.block(0).data();
+    splice_test.splice_back(std::move(splice_part));
+    assert(splice_part.empty() && splice_test.size() == 14 && splice_test.block(2).data() == moved_block &&
+           "splice_back should move the blocks themselves");
+    splice_part.push_back(14);
+    splice_part.push_front(-1);
+    splice_test.splice_back(std::move(splice_part));
+    for (int i = 0; i < 14; i++) {
+        assert(splice_test[i] == i && "splice_back reordered elements");
+    }
+    assert(splice_test.size() == 16 && splice_test[14] == -1 && splice_test.back() == 14 &&
+           "splice_back of an unaligned rope failed");
+
+    // a block aligned splice of more blocks than the directory holds grows it once, both ropes stay whole
+    rope::block_rope<std::string, 4> splice_big;
+    rope::block_rope<std::string, 4> splice_many;
+    for (int i = 0; i < 4; i++) {
+        splice_big.push_back(std::to_string(i));
+    }
+    for (int i = 4; i < 200; i++) {
+        splice_many.push_back(std::to_string(i));
+    }
+    splice_big.splice_back(std::move(splice_many));
+    assert(splice_big.size() == 200 && splice_big.block_count() == 50 && "block aligned splice_back failed");
+    for (int i = 0; i < 200; i++) {
+        assert(splice_big[i] == std::to_string(i) && "block aligned splice_back reordered elements");
+    }
+    assert(splice_many.empty() && splice_many.block_count() == 0 && "splice_back should leave other empty");
+    splice_many.push_back("again");
+    splice_many.push_front("once");
+    assert(splice_many.size() == 2 && splice_many.front() == "once" && splice_many.back() == "again" &&
+           "a spliced from block_rope should be reusable");
+
+    // built on four threads, appended after a short last block, the result matches a sequential build
+    constexpr size_t               count = 100003;
+    rope::block_rope<size_t, 64>   test;
+    for (size_t i = 0; i < 10; i++) {
+        test.push_back(i);
+    }
+    rope::parallel_append_n(test, count, [](size_t i) { return i + 10; }, 4);
+    assert(test.size() == count + 10 && "parallel_append_n lost elements");
+    for (size_t k = 0; k + 1 < test.block_count(); k++) {
+        assert(test.block(k).size() == 64 && "parallel_append_n left a short block in the middle");
+    }
+    for (size_t i = 0; i < test.size(); i++) {
+        assert(test[i] == i && "parallel_append_n out of order");
+    }
+
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 20000; i++) {
+        strings.push_back(std::to_string(i));
+    }
+    rope::block_rope<std::string, 16> string_test;
+    rope::parallel_append(string_test, strings.begin(), strings.end(), 3);
+    assert(std::equal(string_test.begin(), string_test.end(), strings.begin(), strings.end()) &&
+           "parallel_append failed");
+
+    // a throwing make is rethrown on the calling thread
+    [[maybe_unused]] bool threw = false;
+    try {
+        rope::block_rope<int, 16> throw_test;
+        rope::parallel_append_n(throw_test, 50000, [](size_t i) {
+            if (i == 30000)
+                throw std::runtime_error("bad record");
+            return int(i);
+        }, 4);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw && "parallel_append_n should rethrow");
+
+    // the algorithms, on block_rope and on rope's doubling chunks
+    rope::rope<size_t> chunked;
+    for (size_t i = 0; i < count; i++) {
+        chunked.push_back(i);
+    }
+    [[maybe_unused]] const size_t expected_sum = (count + 9) * (count + 10) / 2;
+    assert(rope::parallel_reduce(test, size_t(0), 4) == expected_sum &&
+           rope::parallel_reduce(chunked, size_t(0), 4) == (count - 1) * count / 2 &&
+           "parallel_reduce sum failed");
+    assert(rope::parallel_reduce(test, size_t(0), [](size_t a, size_t b) { return std::max(a, b); }, 4) ==
+               count + 9 &&
+           "parallel_reduce max failed");
+
+    rope::parallel_for_each(test, [](size_t &value) { value *= 2; }, 4);
+    assert(test[12345] == 24690 && test.back() == (count + 9) * 2 && "parallel_for_each failed");
+
+    std::vector<size_t> out(chunked.size());
+    [[maybe_unused]] auto out_end =
+        rope::parallel_transform(chunked, out.begin(), [](size_t value) { return value + 1; }, 4);
+    assert(out_end == out.end() && out.front() == 1 && out.back() == count && out[77777] == 77778 &&
+           "parallel_transform failed");
+
+    output += std::to_string(rope::parallel_reduce(splice_test, 0)) + "\n";
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,264 @@
+// rope_test.cpp : rope and block_rope checks
+//
+#include "rope.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(rope::details::chunk_index(0) == 0);
+static_assert(rope::details::chunk_index(7) == 0);
+static_assert(rope::details::chunk_index(8) == 1);
+static_assert(rope::details::chunk_index(23) == 1);
+static_assert(rope::details::chunk_index(24) == 2);
+static_assert(rope::details::chunk_start(2) == 24);
+
+static_assert(std::random_access_iterator<rope::block_rope<int, 16>::iterator>);
+static_assert(std::random_access_iterator<rope::block_rope<int, 16>::const_iterator>);
+static_assert(std::random_access_iterator<rope::rope<int>::iterator>);
+static_assert(rope::segmented_range<rope::rope<int>> && rope::segmented_range<const rope::block_rope<int, 16>>);
+// a const rope only hands out read only segments
+static_assert(std::is_same_v<decltype(std::declval<const rope::rope<int> &>().segment_at(0)), std::span<const int>>);
+static_assert(std::is_same_v<decltype(std::declval<rope::rope<int> &>().segment_at(0)), std::span<int>>);
+static_assert(std::is_same_v<decltype(std::declval<const rope::block_rope<int, 16> &>().segment_at(0)),
+                             std::span<const int>>);
+static_assert(std::is_same_v<decltype(std::declval<rope::block_rope<int, 16> &>().segment_at(0)), std::span<int>>);
+
+// a copy that may throw, counting how many are alive
+struct copy_throws {
+    static inline int live = 0;
+    std::string       value;
+    bool              throws = false;
+    copy_throws(std::string v, bool t = false) : value(std::move(v)), throws(t) {
+        live++;
+    }
+    copy_throws(const copy_throws &other) : value(other.value), throws(other.throws) {
+        if (throws)
+            throw std::runtime_error("copy_throws");
+        live++;
+    }
+    ~copy_throws() {
+        live--;
+    }
+};
+
+// outlives main's thread cache of blocks, its blocks go back to the shared list instead
+rope::block_rope<int, 8> static_rope;
+
+int main() {
+    std::string output = "";
+
+    rope::rope<size_t> rope_test;
+    assert(rope_test.empty() && rope_test.capacity() == 0 && "default rope should be empty");
+    rope_test.emplace_back(0);
+    [[maybe_unused]] const size_t *first_ptr = &rope_test[0];
+    for (size_t i = 1; i < 1000; i++) {
+        rope_test.push_back(i);
+    }
+    assert(rope_test.size() == 1000 && "rope size is wrong");
+    assert(first_ptr == &rope_test[0] && "rope elements must not move");
+    for (size_t i = 0; i < rope_test.size(); i++) {
+        assert(rope_test[i] == i && "rope value != assigned value");
+    }
+    assert(rope_test.front() == 0 && rope_test.back() == 999 && "rope front / back failed");
+
+    size_t chunk_total = 0;
+    for (size_t k = 0; k < rope_test.chunk_count(); k++) {
+        chunk_total += rope_test.chunk(k).size();
+    }
+    assert(chunk_total == rope_test.size() && "rope chunks don't cover the elements");
+
+    rope::rope<size_t> rope_copy = rope_test;
+    rope_test.pop_back();
+    assert(rope_copy.size() == 1000 && rope_test.size() == 999 && rope_copy[999] == 999 && "rope copy failed");
+    rope::rope<size_t> rope_move = std::move(rope_copy);
+    assert(rope_copy.empty() && rope_move.size() == 1000 && "rope move failed");
+    rope_move.clear();
+    rope_move.shrink_to_fit();
+    assert(rope_move.capacity() == 0 && "rope shrink_to_fit failed");
+
+    // element iterators and the segment wise algorithms agree
+    assert(std::accumulate(rope_test.begin(), rope_test.end(), size_t(0)) == 999 * 998 / 2 &&
+           "rope iterators failed");
+    assert(rope::accumulate(rope_test, size_t(0)) == 999 * 998 / 2 && "rope segment accumulate failed");
+    assert(rope::find(rope_test, size_t(500)).index() == 500 && *rope::find(rope_test, size_t(500)) == 500 &&
+           rope::find(rope_test, size_t(5000)) == rope_test.end() && "rope segment find failed");
+    assert(rope::count(rope_test, size_t(7)) == 1 && "rope segment count failed");
+    std::vector<size_t> rope_out;
+    rope::copy(rope_test, std::back_inserter(rope_out));
+    assert(std::equal(rope_out.begin(), rope_out.end(), rope_test.begin(), rope_test.end()) &&
+           "rope segment copy failed");
+    rope::transform(rope_test, rope_out.begin(), [](size_t value) { return value * 2; });
+    size_t visited = 0, mismatched = 0;
+    rope::for_each(rope_test, [&](size_t &value) {
+        mismatched += rope_out[value] != value * 2;
+        visited++;
+    });
+    assert(visited == rope_test.size() && mismatched == 0 && "rope segment transform / for_each failed");
+    assert((rope_test.begin() + 20).segment().size() == 4 && (rope_test.begin() + 20).segment()[0] == 20 &&
+           "rope iterator segment failed");
+
+    rope::rope<std::string> string_rope;
+    for (size_t i = 0; i < 100; i++) {
+        string_rope.emplace_back(std::to_string(i));
+    }
+    assert(string_rope[42] == "42" && "rope of strings failed");
+    for (size_t i = 0; i < rope_test.size(); i += 100) {
+        output += std::to_string(rope_test[i]) + "\n";
+    }
+
+    output += "___\n";
+    rope::block_rope<int, 8> block_test;
+    for (int i = 0; i < 100; i++) {
+        block_test.push_back(i);
+    }
+    for (int i = 1; i <= 20; i++) {
+        block_test.push_front(-i);
+    }
+    assert(block_test.size() == 120 && block_test.front() == -20 && block_test.back() == 99 &&
+           "block_rope push_back / push_front failed");
+    for (size_t i = 0; i < block_test.size(); i++) {
+        assert(block_test[i] == int(i) - 20 && "block_rope value != assigned value");
+    }
+    size_t block_total = 0;
+    for (size_t k = 0; k < block_test.block_count(); k++) {
+        block_total += block_test.block(k).size();
+        assert((k == 0 || k + 1 == block_test.block_count() || block_test.block(k).size() == 8) &&
+               "block_rope inner blocks must be full");
+    }
+    assert(block_total == block_test.size() && "block_rope blocks don't cover the elements");
+
+    int expected = -20;
+    for ([[maybe_unused]] int value : block_test) {
+        assert(value == expected && "block_rope iterator visited the wrong value");
+        expected++;
+    }
+    assert(std::accumulate(block_test.begin(), block_test.end(), 0) == (99 * 100) / 2 - (20 * 21) / 2 &&
+           "block_rope accumulate failed");
+    assert(*(block_test.begin() + 50) == 30 && (block_test.end() - block_test.begin()) == 120 &&
+           "block_rope iterator arithmetic failed");
+    assert(*std::find(block_test.begin(), block_test.end(), 42) == 42 && "block_rope find failed");
+
+    for (int i = 0; i < 30; i++) {
+        block_test.pop_front();
+        block_test.pop_back();
+    }
+    assert(block_test.size() == 60 && block_test.front() == 10 && block_test.back() == 69 &&
+           "block_rope pop_front / pop_back failed");
+    rope::block_rope<int, 8> block_copy = block_test;
+    block_test.clear();
+    assert(block_test.empty() && block_copy.size() == 60 && block_copy[59] == 69 && "block_rope copy failed");
+
+    assert(rope::accumulate(block_copy, 0) == std::accumulate(block_copy.begin(), block_copy.end(), 0) &&
+           rope::find(block_copy, 42).index() == 32 && rope::count(block_copy, 42) == 1 &&
+           "block_rope segment algorithms failed");
+
+    rope::block_rope<std::unique_ptr<int>, 4> ptr_block_test;
+    for (int i = 0; i < 10; i++) {
+        ptr_block_test.emplace_front(std::make_unique<int>(i));
+        ptr_block_test.emplace_back(std::make_unique<int>(i));
+    }
+    assert(*ptr_block_test[0] == 9 && *ptr_block_test[19] == 9 && *ptr_block_test[10] == 0 &&
+           "block_rope of move only values failed");
+
+    // as a FIFO neither end slides the elements, a pop_front leaves the rest where they are
+    rope::block_rope<std::string, 4> fifo_test;
+    size_t                           fifo_next = 0;
+    bool                             fifo_ok   = true;
+    for (size_t i = 0; i < 1000; i++) {
+        fifo_test.push_back(std::to_string(i));
+        if (i % 3 == 2)
+            fifo_test.push_back(std::to_string(++i));
+        const std::string *second = fifo_test.size() > 1 ? &fifo_test[1] : nullptr;
+        fifo_ok &= fifo_test.front() == std::to_string(fifo_next++);
+        fifo_test.pop_front();
+        fifo_ok &= !second || second == &fifo_test.front();
+    }
+    fifo_ok &= fifo_test.block_count() <= fifo_test.size() / 4 + 2;
+    while (!fifo_test.empty()) {
+        fifo_ok &= fifo_test.front() == std::to_string(fifo_next++);
+        fifo_test.pop_front();
+    }
+    assert(fifo_ok && fifo_next == 1000 && fifo_test.block_count() == 0 && "block_rope as a FIFO failed");
+    output += std::to_string(fifo_next) + "\n";
+
+    // blocks freed by one rope are reused by the next without going back to the system
+    using int_pool = rope::block_rope<int, 8>::pool_type;
+    {
+        rope::block_rope<int, 8> warm;
+        for (int i = 0; i < 200; i++)
+            warm.push_back(i);
+    }
+    [[maybe_unused]] auto before = int_pool::instance().stats();
+    {
+        rope::block_rope<int, 8> reuse;
+        for (int i = 0; i < 200; i++)
+            reuse.push_back(i);
+        assert(reuse[199] == 199 && "block_rope on pooled blocks failed");
+    }
+    [[maybe_unused]] auto after = int_pool::instance().stats();
+    assert(after.misses == before.misses && after.hits > before.hits && "block_pool didn't reuse freed blocks");
+
+    // past the thread cache blocks spill into the shared list and come back a batch at a time
+    {
+        std::vector<void *> blocks;
+        for (size_t i = 0; i < 2 * int_pool::cache_capacity; i++)
+            blocks.push_back(int_pool::instance().allocate());
+        for (void *block : blocks)
+            int_pool::instance().deallocate(block);
+    }
+    auto spilled = int_pool::instance().stats();
+    assert(spilled.flushes > after.flushes && spilled.shared_blocks > 0 && "block_pool thread cache isn't bounded");
+    {
+        std::vector<void *> blocks;
+        for (size_t i = 0; i < int_pool::cache_capacity + spilled.shared_blocks; i++)
+            blocks.push_back(int_pool::instance().allocate());
+        for (void *block : blocks)
+            int_pool::instance().deallocate(block);
+    }
+    [[maybe_unused]] auto refilled = int_pool::instance().stats();
+    assert(refilled.misses == spilled.misses && refilled.refills > spilled.refills &&
+           "block_pool didn't refill from the shared list");
+    int_pool::instance().trim();
+    assert(int_pool::instance().stats().shared_blocks == 0 && "block_pool trim failed");
+    for (int i = 0; i < 100; i++)
+        static_rope.push_back(i);
+
+    // a copy that throws part way frees the elements and chunks it already built
+    {
+        rope::rope<copy_throws> throw_test;
+        for (int i = 0; i < 30; i++)
+            throw_test.emplace_back(std::string(40, char('a' + i % 26)), i == 19);
+        [[maybe_unused]] bool threw = false;
+        try {
+            rope::rope<copy_throws> throw_copy = throw_test;
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && copy_throws::live == 30 && "a throwing rope copy leaked elements");
+    }
+    assert(copy_throws::live == 0 && "rope leaked elements");
+    {
+        rope::block_rope<copy_throws, 8> throw_test;
+        for (int i = 0; i < 30; i++)
+            throw_test.emplace_back(std::string(40, char('a' + i % 26)), i == 19);
+        [[maybe_unused]] bool threw = false;
+        try {
+            rope::block_rope<copy_throws, 8> throw_copy = throw_test;
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && copy_throws::live == 30 && "a throwing block_rope copy leaked elements");
+    }
+    assert(copy_throws::live == 0 && "block_rope leaked elements");
+    for (const auto &value : block_copy) {
+        output += std::to_string(value) + " ";
+    }
+    output += "\n";
+
+    std::cout << output;
+    return 0;
+}
@@ -0,0 +1,102 @@
+// slot_map_test.cpp : stack_slot_map handles, dense storage and erase
+//
+#include "slot_map.h"
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+int main() {
+    std::string output = "";
+
+    using map_type = stack_vector::stack_slot_map<int, 8>;
+    map_type test;
+    assert(test.empty() && test.capacity() == 8 && !test.contains(map_type::handle{}) &&
+           "a default handle should never be live");
+
+    map_type::handle handles[8];
+    for (int i = 0; i < 8; i++) {
+        handles[i] = test.insert(i * 10);
+        assert(test.contains(handles[i]) && test[handles[i]] == i * 10 && "stack_slot_map insert failed");
+    }
+    [[maybe_unused]] const map_type::handle refused = test.insert(80);
+    assert(test.full() && !test.contains(refused) && test.size() == 8 &&
+           "a full stack_slot_map should refuse");
+
+    // erase moves the last element into the hole, every other handle still finds its element
+    [[maybe_unused]] const bool erased       = test.erase(handles[2]);
+    [[maybe_unused]] const bool erased_again = test.erase(handles[2]);
+    assert(erased && !erased_again && "erasing twice should miss");
+    assert(!test.contains(handles[2]) && test.find(handles[2]) == nullptr && test.size() == 7 &&
+           test.data()[2] == 70 && "stack_slot_map erase failed");
+    for (int i = 0; i < 8; i++) {
+        if (i != 2)
+            assert(test.at(handles[i]) == i * 10 && "a handle lost its element after erase");
+    }
+
+    // a reused slot gets a new generation, the old handle stays stale
+    [[maybe_unused]] map_type::handle reused = test.emplace(99);
+    assert(reused.index == handles[2].index && reused.generation != handles[2].generation &&
+           !test.contains(handles[2]) && test[reused] == 99 && "stack_slot_map should reuse freed slots");
+    [[maybe_unused]] bool threw = false;
+    try {
+        (void)test.at(handles[2]);
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw && "at on a stale handle should throw");
+
+    // dense iteration, and back from an element to its handle
+    assert(std::accumulate(test.begin(), test.end(), 0) == 0 + 10 + 30 + 40 + 50 + 60 + 70 + 99 &&
+           "stack_slot_map iteration failed");
+    for (auto it = test.begin(); it != test.end(); ++it) {
+        assert(&test[test.handle_of(it)] == it && "handle_of failed");
+    }
+    for (auto it = test.begin(); it != test.end();) {
+        if (*it % 20 == 0)
+            it = test.erase(it);
+        else
+            ++it;
+    }
+    assert(test.size() == 5 && test.contains(reused) && test[handles[3]] == 30 &&
+           !test.contains(handles[4]) && "erase while iterating failed");
+
+    // churn, the map against a reference of live handles
+    stack_vector::stack_slot_map<std::string, 64> strings;
+    std::vector<std::pair<stack_vector::stack_slot_map<std::string, 64>::handle, std::string>> live;
+    unsigned state = 12345;
+    for (int round = 0; round < 2000; round++) {
+        state = state * 1103515245u + 12345u;
+        if (!live.empty() && (strings.full() || (state >> 16) % 3 == 0)) {
+            const size_t pick = (state >> 8) % live.size();
+            [[maybe_unused]] const bool churn_erased = strings.erase(live[pick].first);
+            assert(churn_erased && "churn erase failed");
+            live[pick] = live.back();
+            live.pop_back();
+        } else {
+            std::string value = std::to_string(round) + std::string(size_t(round % 30), 'x');
+            live.emplace_back(strings.insert(value), value);
+        }
+        assert(strings.size() == live.size() && "churn size mismatch");
+    }
+    for ([[maybe_unused]] const auto &[h, value] : live) {
+        assert(strings.contains(h) && strings[h] == value && "churn lost an element");
+    }
+
+    stack_vector::stack_slot_map<std::string, 64> copy_test = strings;
+    stack_vector::stack_slot_map<std::string, 64> move_test = std::move(strings);
+    assert(strings.empty() && !strings.contains(live.front().first) && "a moved from map should be empty");
+    for ([[maybe_unused]] const auto &[h, value] : live) {
+        assert(copy_test[h] == value && move_test[h] == value && "handles should carry over to copies");
+    }
+    copy_test.clear();
+    assert(copy_test.empty() && !copy_test.contains(live.front().first) && "clear should stale every handle");
+
+    for (int value : test.values()) {
+        output += std::to_string(value) + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+// small_vector_test.cpp : small_vector checks, inline and spilled
+//
+#include "small_vector.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+static_assert(stack_vector::small_vector<int, 4>::inline_capacity == 4);
+
+int main() {
+    std::string output = "";
+
+    stack_vector::small_vector<int, 4> test;
+    assert(test.empty() && test.capacity() == 4 && test.is_inline() && "default small_vector should be empty");
+    for (int i = 0; i < 4; i++) {
+        test.push_back(i);
+    }
+    assert(test.is_inline() && test.size() == 4 && "small_vector should stay inline up to N");
+    test.push_back(4);
+    assert(!test.is_inline() && test.capacity() >= 5 && "small_vector should spill past N");
+    for (int i = 5; i < 100; i++) {
+        test.emplace_back(i);
+    }
+    for (int i = 0; i < 100; i++) {
+        assert(test[i] == i && "small_vector value != assigned value");
+    }
+    assert(test.capacity() < 256 && "small_vector growth should be geometric");
+
+    // an argument referring to an element survives the reallocation
+    stack_vector::small_vector<std::string, 2> alias_test = {"a", "b"};
+    alias_test.push_back(alias_test[0]);
+    assert(alias_test.size() == 3 && alias_test[2] == "a" && "push_back of an element failed");
+
+    test.insert(test.begin(), -1);
+    test.insert(test.begin() + 50, 3, 7);
+    assert(test.front() == -1 && test[50] == 7 && test[52] == 7 && test[53] == 49 && test.size() == 104 &&
+           "small_vector insert failed");
+    test.erase(test.begin() + 50, test.begin() + 53);
+    test.erase(test.begin());
+    for (int i = 0; i < 100; i++) {
+        assert(test[i] == i && "small_vector erase failed");
+    }
+
+    // back into the inline buffer once everything fits again
+    test.resize(3);
+    test.shrink_to_fit();
+    assert(test.is_inline() && test.size() == 3 && test[2] == 2 && "small_vector shrink_to_fit failed");
+
+    stack_vector::small_vector<int, 4> copy_test = test;
+    test.append(10, 9);
+    stack_vector::small_vector<int, 4> move_test = std::move(test);
+    assert(copy_test.size() == 3 && move_test.size() == 13 && !move_test.is_inline() && test.empty() &&
+           test.is_inline() && "small_vector copy / move failed");
+    copy_test.swap(move_test);
+    assert(copy_test.size() == 13 && move_test.size() == 3 && move_test.is_inline() && "small_vector swap failed");
+    const size_t erased = std::erase(copy_test, 9);
+    output += std::to_string(erased) + "\n";
+    assert(erased == 10 && copy_test == move_test && "small_vector erase / == failed");
+
+    // past STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES an inline move takes only the live elements
+    stack_vector::small_vector<int, 4096> wide_test = {1, 2, 3};
+    stack_vector::small_vector<int, 4096> wide_moved = std::move(wide_test);
+    wide_test = std::move(wide_moved);
+    assert(wide_test.is_inline() && wide_test.size() == 3 && wide_test[2] == 3 && wide_moved.empty() &&
+           "small_vector inline move of a wide buffer failed");
+
+    stack_vector::small_vector<std::string, 2> string_test;
+    for (int i = 0; i < 10; i++) {
+        string_test.insert(string_test.begin(), std::to_string(i));
+    }
+    assert(string_test.front() == "9" && string_test.back() == "0" && "small_vector of strings failed");
+    std::erase_if(string_test, [](const std::string &value) { return value < "5"; });
+    assert(string_test.size() == 5 && string_test.back() == "5" && "small_vector erase_if failed");
+    // a gap wider than the tail behind it, part of it lands past the old end
+    const std::string more[] = {"a", "b", "c"};
+    string_test.insert(string_test.end() - 1, std::begin(more), std::end(more));
+    assert(string_test.size() == 8 && string_test[4] == "a" && string_test[6] == "c" &&
+           string_test[7] == "5" && "small_vector insert of strings failed");
+
+    stack_vector::small_vector<std::unique_ptr<int>, 2> ptr_test;
+    for (int i = 0; i < 6; i++) {
+        ptr_test.emplace(ptr_test.begin(), std::make_unique<int>(i));
+    }
+    ptr_test.erase(ptr_test.begin() + 1);
+    assert(*ptr_test[0] == 5 && *ptr_test[1] == 3 && ptr_test.size() == 5 && "small_vector of unique_ptrs failed");
+
+    for (const auto &int_val : move_test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+// spsc_queue_test.cpp : spsc_queue checks, single threaded edges then a producer / consumer pair
+//
+#include "spsc_queue.h"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+static_assert(stack_vector::spsc_queue<int, 5>::capacity() == 8);
+static_assert(alignof(stack_vector::spsc_queue<int, 8>) >= STACK_VECTOR_CACHE_LINE_SIZE);
+
+// copies and move assignments throw when asked to, counting how many are alive
+struct throws_on {
+    static inline int live   = 0;
+    int               value  = 0;
+    bool              throws = false;
+    throws_on(int v = 0, bool t = false) : value(v), throws(t) {
+        live++;
+    }
+    throws_on(const throws_on &other) : value(other.value), throws(other.throws) {
+        if (throws)
+            throw std::runtime_error("throws_on");
+        live++;
+    }
+    throws_on &operator=(throws_on &&other) {
+        if (other.throws)
+            throw std::runtime_error("throws_on");
+        value = other.value;
+        return *this;
+    }
+    ~throws_on() {
+        live--;
+    }
+};
+
+int main() {
+    std::string output = "";
+
+    stack_vector::spsc_queue<int, 4> test;
+    int                              value       = -1;
+    [[maybe_unused]] const bool      popped_none = test.try_pop(value);
+    assert(test.empty() && !popped_none && value == -1 && "a new spsc_queue should be empty");
+    for (int i = 0; i < 4; i++) {
+        [[maybe_unused]] const bool pushed = test.try_push(i);
+        assert(pushed && "spsc_queue push failed");
+    }
+    [[maybe_unused]] const bool pushed_full = test.try_push(4);
+    assert(!pushed_full && test.size_approx() == 4 && "a full spsc_queue should refuse");
+    [[maybe_unused]] const bool popped_first = test.try_pop(value);
+    assert(popped_first && value == 0 && "spsc_queue should pop in order");
+
+    // batches wrap around the end of the ring
+    const int                     batch[3]    = {10, 11, 12};
+    [[maybe_unused]] const size_t pushed_some = test.try_push_n(batch, 3);
+    assert(pushed_some == 1 && "try_push_n should stop when full");
+    int                           out[8]     = {};
+    [[maybe_unused]] const size_t popped_all = test.try_pop_n(out, 8);
+    assert(popped_all == 4 && out[0] == 1 && out[3] == 10 && test.empty() &&
+           "try_pop_n should take everything there is");
+    [[maybe_unused]] const size_t pushed_span = test.try_push_n(std::span<const int>(batch));
+    [[maybe_unused]] const size_t popped_span = test.try_pop_n(std::span<int>(out));
+    assert(pushed_span == 3 && popped_span == 3 && out[0] == 10 && out[2] == 12 &&
+           "spsc_queue batches across the wrap failed");
+
+    {
+        // whatever is left at destruction is destroyed
+        stack_vector::spsc_queue<std::shared_ptr<int>, 4> ptr_test;
+        auto                                              shared = std::make_shared<int>(1);
+        ptr_test.try_push(shared);
+        ptr_test.try_emplace(shared);
+        std::shared_ptr<int>        popped;
+        [[maybe_unused]] const bool popped_ptr = ptr_test.try_pop(popped);
+        assert(popped_ptr && shared.use_count() == 3 && "spsc_queue of shared_ptrs failed");
+    }
+
+    {
+        // a throwing copy in the second run takes the first run with it, a throwing move keeps what came out
+        stack_vector::spsc_queue<throws_on, 4> throw_test;
+        for (int i = 0; i < 3; i++) {
+            [[maybe_unused]] const bool pushed = throw_test.try_emplace(i);
+            [[maybe_unused]] throws_on  popped;
+            [[maybe_unused]] const bool popped_one = throw_test.try_pop(popped);
+        }
+        const throws_on batch_with_thrower[3] = {throws_on(1), throws_on(2), throws_on(3, true)};
+        [[maybe_unused]] const int live_before = throws_on::live;
+        [[maybe_unused]] bool      threw       = false;
+        try {
+            throw_test.try_push_n(batch_with_thrower, 3);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && throw_test.empty() && throws_on::live == live_before &&
+               "a throwing try_push_n should publish and leak nothing");
+
+        [[maybe_unused]] const bool pushed_plain   = throw_test.try_emplace(4);
+        [[maybe_unused]] const bool pushed_thrower = throw_test.try_emplace(5, true);
+        throws_on                   popped[2];
+        threw = false;
+        try {
+            throw_test.try_pop_n(popped, 2);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && popped[0].value == 4 && throw_test.size_approx() == 1 &&
+               throws_on::live == live_before + 3 && "a throwing try_pop_n should free what it moved out");
+    }
+    assert(throws_on::live == 0 && "spsc_queue leaked a value");
+
+    // one producer and one consumer, singles and batches mixed, every value arrives once and in order
+    constexpr uint64_t                      total = 1000000;
+    stack_vector::spsc_queue<uint64_t, 256> queue;
+    std::thread                             producer([&] {
+        uint64_t              next = 0;
+        std::vector<uint64_t> chunk(37);
+        while (next < total) {
+            size_t pushed = 0;
+            if (next % 3) {
+                pushed = queue.try_push(next);
+            } else {
+                const uint64_t count = std::min<uint64_t>(chunk.size(), total - next);
+                for (uint64_t i = 0; i < count; i++)
+                    chunk[i] = next + i;
+                pushed = queue.try_push_n(chunk.data(), size_t(count));
+            }
+            next += pushed;
+            if (!pushed)
+                std::this_thread::yield(); // the test machine may have a single core
+        }
+    });
+    uint64_t              expected = 0;
+    bool                  in_order = true;
+    std::vector<uint64_t> received(64);
+    while (expected < total) {
+        const size_t count = queue.try_pop_n(received.data(), (expected % 5) ? received.size() : 1);
+        for (size_t i = 0; i < count; i++)
+            in_order &= received[i] == expected++;
+        if (!count)
+            std::this_thread::yield();
+    }
+    producer.join();
+    assert(in_order && queue.empty() && "spsc_queue lost or reordered values across threads");
+
+    output += std::to_string(expected) + "\n";
+
+    std::cout << output;
+
+    return 0;
+}
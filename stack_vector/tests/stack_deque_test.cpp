@@ -0,0 +1,104 @@
+// stack_deque_test.cpp : stack_deque checks, wrapping at both ends
+//
+#include "stack_deque.h"
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+
+static_assert(stack_vector::stack_deque<int, 5>::ring_capacity == 8);
+static_assert(stack_vector::stack_deque<int, 8>::ring_capacity == 8);
+static_assert(std::random_access_iterator<stack_vector::stack_deque<int, 8>::iterator>);
+
+int main() {
+    std::string output = "";
+
+    stack_vector::stack_deque<int, 5> test;
+    assert(test.empty() && test.capacity() == 8 && "default stack_deque should be empty");
+    for (int i = 0; i < 4; i++) {
+        test.push_back(i);
+        test.push_front(-i - 1);
+    }
+    assert(test.full() && test.front() == -4 && test.back() == 3 && "stack_deque push at both ends failed");
+    [[maybe_unused]] const bool pushed_back  = test.push_back(4);
+    [[maybe_unused]] const bool pushed_front = test.push_front(-5);
+    assert(!pushed_back && !pushed_front && test.size() == 8 && "a full stack_deque should refuse");
+    for (int i = 0; i < 8; i++) {
+        assert(test[i] == i - 4 && test.at(i) == i - 4 && "stack_deque value != pushed value");
+    }
+
+    // the front half sits at the end of the ring, so the elements come back in two runs
+    [[maybe_unused]] auto [first, second] = test.as_spans();
+    assert(first.size() == 4 && second.size() == 4 && first[0] == -4 && second[0] == 0 &&
+           "stack_deque as_spans failed");
+
+    test.pop_front();
+    test.pop_back();
+    assert(test.size() == 6 && test.front() == -3 && test.back() == 2 && "stack_deque pop failed");
+    test.pop_front_n(4);
+    assert(test.size() == 2 && test.front() == 1 && test.as_spans().second.empty() && "stack_deque pop_front_n failed");
+
+    // against std::deque with random traffic, wrapping many times
+    stack_vector::stack_deque<std::string, 16> string_test;
+    std::deque<std::string>                    reference;
+    std::mt19937                               gen(11);
+    for (int i = 0; i < 5000; i++) {
+        const std::string value = std::to_string(i);
+        switch (gen() % 4) {
+        case 0:
+            if (string_test.push_back(value))
+                reference.push_back(value);
+            break;
+        case 1:
+            if (string_test.push_front(value))
+                reference.push_front(value);
+            break;
+        case 2:
+            if (!string_test.empty()) {
+                string_test.pop_back();
+                reference.pop_back();
+            }
+            break;
+        default:
+            if (!string_test.empty()) {
+                string_test.pop_front();
+                reference.pop_front();
+            }
+            break;
+        }
+        assert(string_test.size() == reference.size() &&
+               std::equal(string_test.begin(), string_test.end(), reference.begin(), reference.end()) &&
+               "stack_deque disagrees with std::deque");
+    }
+    [[maybe_unused]] size_t span_total = string_test.as_spans().first.size() + string_test.as_spans().second.size();
+    assert(span_total == string_test.size() && "stack_deque as_spans should cover every element");
+
+    stack_vector::stack_deque<std::string, 16> copy_test = string_test;
+    stack_vector::stack_deque<std::string, 16> move_test = std::move(string_test);
+    assert(copy_test == move_test && string_test.empty() && "stack_deque copy / move failed");
+    copy_test.push_back("x");
+    move_test.swap(copy_test);
+    assert(move_test.back() == "x" && move_test.size() == copy_test.size() + 1 && "stack_deque swap failed");
+
+    stack_vector::stack_deque<std::unique_ptr<int>, 4> ptr_test;
+    for (int i = 0; i < 10; i++) {
+        if (ptr_test.full())
+            ptr_test.pop_front();
+        ptr_test.emplace_back(std::make_unique<int>(i));
+    }
+    assert(*ptr_test.front() == 6 && *ptr_test.back() == 9 && "stack_deque of unique_ptrs failed");
+
+    stack_vector::stack_deque<int, 4> sort_test = {3, 1, 2};
+    sort_test.push_front(4);
+    std::sort(sort_test.begin(), sort_test.end());
+    assert(sort_test == (stack_vector::stack_deque<int, 4>{1, 2, 3, 4}) && "stack_deque sort failed");
+
+    for (const auto &int_val : test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
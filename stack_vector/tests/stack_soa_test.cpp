@@ -0,0 +1,146 @@
+// stack_soa_test.cpp : stack_soa checks, columns kept in step
+//
+#include "stack_soa.h"
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+using particles = stack_vector::stack_soa<64, float, float, int>;
+static_assert(particles::column_count == 3 && std::is_same<particles::column_type<2>, int>::value);
+static_assert(std::random_access_iterator<particles::iterator>);
+static_assert([] {
+    stack_vector::stack_soa<4, int, float> a;
+    a.emplace_back(1, 2.0f);
+    a.emplace_back(3, 4.0f);
+    auto b = a;
+    auto c = std::move(b);
+    return c.size() == 2 && c.column<0>()[1] == 3 && c.column<1>()[0] == 2.0f;
+}());
+
+// counts the live instances, to see a throwing column's neighbours get destroyed
+struct counted {
+    static inline int live = 0;
+    counted() noexcept {
+        live += 1;
+    }
+    counted(const counted &) noexcept {
+        live += 1;
+    }
+    ~counted() {
+        live -= 1;
+    }
+};
+// throws when built or copied with fail set
+struct picky {
+    bool fail = false;
+    explicit picky(bool f) : fail(f) {
+        if (fail)
+            throw std::runtime_error("picky");
+    }
+    picky(const picky &other) : fail(other.fail) {
+        if (fail)
+            throw std::runtime_error("picky copy");
+    }
+};
+
+int main() {
+    std::string output = "";
+
+    particles test;
+    assert(test.empty() && test.capacity() == 64 && "default stack_soa should be empty");
+    for (int i = 0; i < 10; i++) {
+        [[maybe_unused]] const auto emplaced = test.emplace_back(float(i), float(i) * 2.0f, i);
+        assert(emplaced && "stack_soa emplace_back failed");
+    }
+    assert(test.size() == 10 && test.column<0>().size() == 10 && test.column<2>()[7] == 7 &&
+           "stack_soa columns should share the size");
+    assert(size_t(test.column<0>().data()) % STACK_VECTOR_SOA_ALIGNMENT == 0 &&
+           size_t(test.column<1>().data()) % STACK_VECTOR_SOA_ALIGNMENT == 0 &&
+           size_t(test.column<2>().data()) % STACK_VECTOR_SOA_ALIGNMENT == 0 &&
+           "stack_soa columns must be aligned");
+
+    // rows are tuples of references into the columns
+    [[maybe_unused]] auto [x, y, id] = test[3];
+    x                                = 30.0f;
+    assert(test.column<0>()[3] == 30.0f && y == 6.0f && id == 3 && "stack_soa row access failed");
+    std::get<1>(test.back()) = -1.0f;
+    assert(test.column<1>()[9] == -1.0f && std::get<2>(test.front()) == 0 && "stack_soa front / back failed");
+    [[maybe_unused]] const particles &const_test = test;
+    assert(std::get<0>(const_test.at(3)) == 30.0f && "stack_soa const rows failed");
+
+    // erase keeps the order, swap_erase moves the last row in
+    test.erase(test.begin() + 1);
+    assert(test.size() == 9 && test.column<2>()[1] == 2 && test.column<0>()[2] == 30.0f &&
+           "stack_soa erase failed");
+    [[maybe_unused]] const auto swapped = test.swap_erase(test.begin());
+    assert(test.size() == 8 && test.column<2>()[0] == 9 && test.column<1>()[0] == -1.0f &&
+           test.column<2>()[1] == 2 && swapped == test.begin() && "stack_soa swap_erase failed");
+    test.erase(test.begin() + 2, test.begin() + 5);
+    [[maybe_unused]] const int remaining[] = {9, 2, 6, 7, 8};
+    assert(std::equal(test.column<2>().begin(), test.column<2>().end(), remaining, remaining + 5) &&
+           "stack_soa range erase failed");
+
+    int id_sum = 0;
+    for (auto [px, py, pid] : test) {
+        id_sum += pid;
+        py = px;
+    }
+    assert(id_sum == std::accumulate(remaining, remaining + 5, 0) && test.column<1>()[1] == 2.0f &&
+           "stack_soa iteration failed");
+
+    // non trivial columns are copied, moved and destroyed in step
+    stack_vector::stack_soa<4, std::string, int> string_test;
+    string_test.emplace_back("one", 1);
+    string_test.push_back({"two", 2});
+    string_test.emplace_back(std::string(40, 'x'), 3);
+    stack_vector::stack_soa<4, std::string, int> copy_test = string_test;
+    stack_vector::stack_soa<4, std::string, int> move_test = std::move(string_test);
+    assert(string_test.empty() && copy_test.size() == 3 && move_test.column<0>()[2].size() == 40 &&
+           std::get<0>(copy_test[1]) == "two" && "stack_soa copy / move failed");
+    move_test.swap_erase(move_test.cbegin());
+    move_test.pop_back();
+    assert(move_test.size() == 1 && std::get<0>(move_test[0]).size() == 40 &&
+           std::get<1>(move_test[0]) == 3 &&
+           "stack_soa swap_erase / pop_back of strings failed");
+    copy_test.emplace_back("four", 4);
+    [[maybe_unused]] const auto emplaced_full = copy_test.emplace_back("five", 5);
+    assert(copy_test.full() && !emplaced_full && copy_test.size() == 4 &&
+           "a full stack_soa should refuse");
+
+    // a throwing column takes the row's other fields down with it
+    {
+        stack_vector::stack_soa<4, counted, std::unique_ptr<int>, std::string, picky> throw_test;
+        throw_test.emplace_back(counted{}, std::make_unique<int>(1), std::string(40, 'x'), false);
+        [[maybe_unused]] bool threw = false;
+        try {
+            throw_test.emplace_back(counted{}, std::make_unique<int>(2), std::string(40, 'y'), true);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && throw_test.size() == 1 && counted::live == 1 &&
+               "a throwing emplace_back should leave no fields behind");
+
+        stack_vector::stack_soa<4, counted, std::string, picky> copy_source;
+        copy_source.emplace_back(counted{}, std::string(40, 'a'), false);
+        copy_source.emplace_back(counted{}, std::string(40, 'b'), false);
+        std::get<2>(copy_source[1]).fail = true;
+        threw = false;
+        try {
+            stack_vector::stack_soa<4, counted, std::string, picky> copy_fail = copy_source;
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw && counted::live == 3 && "a throwing copy should destroy the columns it built");
+    }
+    assert(counted::live == 0 && "stack_soa leaked a column");
+
+    for (float value : test.column<1>()) {
+        output += std::to_string(value) + "\n";
+    }
+
+    std::cout << output;
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+// stack_string_test.cpp : stack_string checks
+//
+#include "stack_string.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+static_assert(std::is_trivially_copyable_v<stack_vector::stack_string<31>>);
+static_assert(sizeof(stack_vector::stack_string<30>) == 32);
+static_assert(!std::is_trivially_copyable_v<stack_vector::stack_string<300>>);
+
+int main() {
+    std::string output = "";
+
+    stack_vector::stack_string<16> test;
+    assert(test.empty() && test.c_str()[0] == '\0' && test.capacity() == 16 && "default stack_string should be empty");
+    test.append("metric");
+    test += '.';
+    test += "latency";
+    assert(test == "metric.latency" && test.size() == 14 && test.c_str()[14] == '\0' &&
+           std::as_const(test)[test.size()] == '\0' && test[test.size()] == '\0' && "stack_string append failed");
+    assert(test.find("latency") == 7 && test.find('x') == test.npos && test.contains("ic.la") &&
+           test.starts_with("metric") && test.ends_with("ency") && test.rfind('t') == 9 &&
+           "stack_string searches failed");
+
+    // past the capacity the append is dropped (the default _noop handling), the terminator stays put
+    test.append("_too_long");
+    assert(test.size() == 14 && test.c_str()[14] == '\0' && "stack_string overflow should noop");
+    test.pop_back();
+    test.append(2, 'y');
+    assert(test == "metric.latencyy" && test.size() == 15 && "stack_string append count failed");
+
+    stack_vector::stack_string<16> copy_test = test;
+    copy_test.resize(6);
+    assert(copy_test == "metric" && copy_test < test && copy_test.compare("metric") == 0 &&
+           "stack_string copy / resize / compare failed");
+    stack_vector::stack_string<32> wide_test(copy_test);
+    assert(wide_test == copy_test && "stack_string comparisons across capacities failed");
+
+    stack_vector::stack_string<8> number_test = "n=";
+    [[maybe_unused]] const bool   number_fit  = number_test.append_number(42);
+    assert(number_fit && number_test == "n=42" && "stack_string append_number failed");
+    [[maybe_unused]] const bool number_overflow = number_test.append_number(123456);
+    assert(!number_overflow && number_test == "n=42" && number_test.c_str()[4] == '\0' &&
+           "append_number past capacity should noop");
+    output += std::string(number_test.view()) + "\n";
+#if defined(__cpp_lib_format)
+    stack_vector::stack_string<8> format_test;
+    [[maybe_unused]] const bool   format_fit  = format_test.format_append("{}-{}", 1, 2);
+    assert(format_fit && format_test == "1-2" && "stack_string format_append failed");
+    [[maybe_unused]] const bool format_overflow = format_test.format_append("{}", 123456789);
+    assert(!format_overflow && format_test == "1-2" && "format_append past capacity should noop");
+    output += std::string(format_test.view()) + "\n";
+#endif
+
+    // past STACK_VECTOR_TRIVIAL_COPY_MAX_BYTES the stack_vector copies only its chars, the terminator has
+    // to be written again, the copies here land on memory full of 'X's
+    using wide_string = stack_vector::stack_string<300>;
+    alignas(wide_string) unsigned char copy_bytes[sizeof(wide_string)];
+    alignas(wide_string) unsigned char move_bytes[sizeof(wide_string)];
+    std::memset(copy_bytes, 'X', sizeof(copy_bytes));
+    std::memset(move_bytes, 'X', sizeof(move_bytes));
+    const wide_string hi         = "hi";
+    wide_string      *wide_copy  = ::new (copy_bytes) wide_string(hi);
+    wide_string      *wide_moved = ::new (move_bytes) wide_string(wide_string("hey"));
+    [[maybe_unused]] const size_t copy_length = std::strlen(wide_copy->c_str());
+    [[maybe_unused]] const size_t move_length = std::strlen(wide_moved->c_str());
+    assert(copy_length == 2 && move_length == 3 && "wide stack_string copies must be terminated");
+    *wide_copy  = wide_string("hello world");
+    *wide_copy  = hi;
+    *wide_moved = wide_string("hello world");
+    *wide_moved = wide_string("hey");
+    assert(std::strlen(wide_copy->c_str()) == 2 && std::strlen(wide_moved->c_str()) == 3 &&
+           "wide stack_string assignments must be terminated");
+    output += std::string(wide_copy->c_str()) + " " + wide_moved->c_str() + "\n";
+    wide_copy->~wide_string();
+    wide_moved->~wide_string();
+
+    std::unordered_set<stack_vector::stack_string<16>> key_set;
+    key_set.insert("a.b");
+    key_set.insert(test);
+    assert(key_set.count("a.b") == 1 &&
+           std::hash<stack_vector::stack_string<16>>()(test) == std::hash<std::string_view>()(test.view()) &&
+           "stack_string hashing failed");
+
+    std::string_view view = test;
+    output += std::string(view) + "\n";
+    output += std::string(copy_test.c_str()) + "\n";
+
+    std::cout << output;
+
+    return 0;
+}
@@ -1,8 +1,32 @@
 ﻿// stack_vector_test.cpp : Defines the entry point for the application.
 //
 #include "stack_vector.h"
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
+
+// the size counter only needs to count to N
+static_assert(sizeof(stack_vector::stack_vector<uint8_t, 15>) == 16);
+static_assert(sizeof(stack_vector::stack_vector<uint8_t, 255>) == 256);
+static_assert(sizeof(stack_vector::stack_vector<uint8_t, 256>) == 258);
+static_assert(sizeof(stack_vector::stack_vector<uint16_t, 7>) == 16);
+static_assert(sizeof(stack_vector::stack_vector<uint32_t, 3, stack_vector::size_layout::_after>) == 16);
+static_assert(sizeof(stack_vector::stack_vector<uint64_t, 3>) == 32);
+
+// trivially copyable T's make (reasonably sized) trivially copyable stack_vectors
+static_assert(std::is_trivially_copyable_v<stack_vector::stack_vector<int, 5>>);
+static_assert(std::is_trivially_copyable_v<stack_vector::stack_vector<int, 5, stack_vector::size_layout::_after>>);
+static_assert(!std::is_trivially_copyable_v<stack_vector::stack_vector<int, 1024>>);
+static_assert(!std::is_trivially_copyable_v<stack_vector::stack_vector<std::string, 5>>);
+
+static_assert(stack_vector::is_trivially_relocatable_v<int>);
+static_assert(stack_vector::is_trivially_relocatable_v<std::unique_ptr<int>>);
+static_assert(!stack_vector::is_trivially_relocatable_v<std::string>);
 
 constexpr bool constexpr_test() {
     bool                               test_ok = false;
@@ -33,7 +57,7 @@ constexpr bool constexpr_test() {
     }
     for (size_t i = 0; i < test.capacity(); i++) {
         test_ok &= test[i] == test.begin()[i];
-        test_ok &= test[i] == i;
+        test_ok &= test[i] == int(i);
     }
     test_ok &= test.size() == test.capacity();
 
@@ -41,9 +65,239 @@ constexpr bool constexpr_test() {
     test.pop_back();
     test_ok &= test.size() == (test.capacity() - 2);
 
+    // the rest of the api, in a constant expression
+    stack_vector::stack_vector<int, 16> api_test = {5, 1, 4};
+    const int                           more[]   = {9, 2, 6};
+    api_test.insert(api_test.begin() + 1, more, more + 3); // 5 9 2 6 1 4
+    api_test.insert(api_test.begin(), 2, api_test[3]);     // 6 6 5 9 2 6 1 4
+    api_test.emplace(api_test.begin() + 4, 7);             // 6 6 5 9 7 2 6 1 4
+    api_test.erase(api_test.begin(), api_test.begin() + 2);
+    api_test.erase(api_test.begin() + 1); // 5 7 2 6 1 4
+    api_test.append(more, more + 2);      // 5 7 2 6 1 4 9 2
+    api_test.append(1, 3);                // 5 7 2 6 1 4 9 2 3
+    test_ok &= std::erase(api_test, 2) == 2 && stack_vector::count(api_test, 9) == 1 &&
+               stack_vector::contains(api_test, 3) && *stack_vector::find(api_test, 6) == 6;
+    const size_t expired[] = {0, 2};
+    test_ok &= api_test.erase_indices(expired) == 2; // 7 1 4 9 3
+    api_test.swap_erase(api_test.begin());           // 3 1 4 9
+    const size_t gaps[]   = {1, 4};
+    const int    values[] = {8, 0};
+    test_ok &= api_test.insert_many(gaps, values); // 3 8 1 4 9 0
+    api_test.resize(8);
+    api_test.resize_default_init(9);
+    test_ok &= api_test.size() == 9 && api_test[0] == 3 && api_test[1] == 8 && api_test[5] == 0 &&
+               api_test[7] == 0;
+
+    api_test.sort(); // 0 0 0 0 1 3 4 8 9
+    test_ok &= std::is_sorted(api_test.begin(), api_test.end());
+    api_test.partial_sort(api_test.begin() + 2, std::greater<>{}); // 9 8 ...
+    test_ok &= api_test[0] == 9 && api_test[1] == 8;
+    api_test.sort();
+
+    stack_vector::stack_vector<int, 16> copy_test = api_test;
+    stack_vector::stack_vector<int, 16> swap_test(3, 1);
+    copy_test.swap(swap_test);
+    test_ok &= swap_test == api_test && copy_test.size() == 3 && copy_test > api_test &&
+               copy_test != api_test;
+    test_ok &= stack_vector::append(copy_test, swap_test).size() == 12;
+
+    // non trivial T's work too, as long as they are gone by the end of the evaluation
+    stack_vector::stack_vector<std::string, 4> string_test = {"a", "b"};
+    string_test.insert(string_test.begin(), std::string("c"));
+    string_test.erase(string_test.begin() + 1);
+    test_ok &= string_test.size() == 2 && string_test[0] == "c" && string_test[1] == "b";
+
+    // past the sorting network's size pdqsort takes over
+    stack_vector::stack_vector<int, 128> pdq_test;
+    for (int i = 0; i < 100; i++)
+        pdq_test.shove_back((i * 37) % 100);
+    pdq_test.nth_element(pdq_test.begin() + 50);
+    test_ok &= pdq_test[50] == 50;
+    pdq_test.sort();
+    for (int i = 0; i < 100; i++)
+        test_ok &= pdq_test[i] == i;
+
+    return test_ok;
+}
+static_assert(constexpr_test());
+
+// a stack_vector is a structural type, so it can be a template argument (of structural T's)
+template <stack_vector::stack_vector<int, 8> Values> constexpr int sum_of() {
+    int sum = 0;
+    for (int value : Values)
+        sum += value;
+    return sum;
+}
+static_assert(sum_of<stack_vector::stack_vector<int, 8>{1, 2, 3}>() == 6);
+static_assert(sum_of<stack_vector::stack_vector<int, 8>{}>() == 0);
+
+// and tables built by constexpr code need no startup initialization
+constexpr stack_vector::stack_vector<uint8_t, 256> make_hex_table() {
+    stack_vector::stack_vector<uint8_t, 256> table(256, uint8_t(0xff));
+    for (int i = 0; i < 10; i++)
+        table['0' + i] = uint8_t(i);
+    for (int i = 0; i < 6; i++) {
+        table['a' + i] = uint8_t(10 + i);
+        table['A' + i] = uint8_t(10 + i);
+    }
+    return table;
+}
+constinit stack_vector::stack_vector<uint8_t, 256> hex_table = make_hex_table();
+static_assert(make_hex_table()['f'] == 15 && make_hex_table()['g'] == 0xff);
+
+// a copy that may throw
+struct copy_throws {
+    std::string value;
+    bool        throws = false;
+    copy_throws(std::string v, bool t = false) : value(std::move(v)), throws(t) {
+    }
+    copy_throws(const copy_throws &other) : value(other.value), throws(other.throws) {
+        if (throws)
+            throw std::runtime_error("copy_throws");
+    }
+    copy_throws(copy_throws &&) noexcept            = default;
+    copy_throws &operator=(const copy_throws &)     = default;
+    copy_throws &operator=(copy_throws &&) noexcept = default;
+};
+
+// relocatable, with a copy that may throw, counting how many are alive
+struct relocatable_throws {
+    static inline int    live = 0;
+    std::unique_ptr<int> value;
+    bool                 throws = false;
+    relocatable_throws(int v, bool t = false) : value(std::make_unique<int>(v)), throws(t) {
+        live++;
+    }
+    relocatable_throws(const relocatable_throws &other)
+        : value(std::make_unique<int>(*other.value)), throws(other.throws) {
+        if (throws)
+            throw std::runtime_error("relocatable_throws");
+        live++;
+    }
+    relocatable_throws(relocatable_throws &&other) noexcept
+        : value(std::move(other.value)), throws(other.throws) {
+        live++;
+    }
+    relocatable_throws &operator=(const relocatable_throws &other) {
+        if (other.throws)
+            throw std::runtime_error("relocatable_throws");
+        value = std::make_unique<int>(*other.value);
+        return *this;
+    }
+    relocatable_throws &operator=(relocatable_throws &&other) noexcept {
+        value  = std::move(other.value);
+        throws = other.throws;
+        return *this;
+    }
+    ~relocatable_throws() {
+        live--;
+    }
+};
+template <> struct stack_vector::is_trivially_relocatable<relocatable_throws> : std::true_type {};
+
+// converts to an int, throwing for 2
+struct converts_throws {
+    int value;
+    operator int() const {
+        if (value == 2)
+            throw std::runtime_error("converts_throws");
+        return value;
+    }
+};
+
+// the arithmetic kernels against the plain algorithms, lengths cover the vector bodies and the tails
+template <typename T> bool kernel_test() {
+    bool test_ok = true;
+    for (size_t len = 0; len < 80; len += 7) {
+        stack_vector::stack_vector<T, 80> test;
+        for (size_t i = 0; i < len; i++)
+            test.shove_back(T((i * 7) % 5));
+        test_ok &= stack_vector::count(test, T(3)) == size_t(std::count(test.begin(), test.end(), T(3)));
+        test_ok &= stack_vector::find(test, T(4)) == std::find(test.begin(), test.end(), T(4));
+        test_ok &= stack_vector::contains(test, T(9)) == false;
+
+        std::vector<T> expected(test.begin(), test.end());
+        size_t         removed = size_t(expected.end() - std::remove(expected.begin(), expected.end(), T(2)));
+        expected.resize(expected.size() - removed);
+        test_ok &= std::erase(test, T(2)) == removed;
+        test_ok &= std::equal(test.begin(), test.end(), expected.begin(), expected.end());
+
+        auto below_two = [](T v) { return v < T(2); };
+        removed        = size_t(expected.end() - std::remove_if(expected.begin(), expected.end(), below_two));
+        expected.resize(expected.size() - removed);
+        test_ok &= std::erase_if(test, below_two) == removed;
+        test_ok &= std::equal(test.begin(), test.end(), expected.begin(), expected.end());
+    }
+    return test_ok;
+}
+
+// an integer needle of another type is compared the way == compares it, sign conversions included
+template <typename T, typename U> bool mixed_kernel_test(U needle) {
+    stack_vector::stack_vector<T, 40> test;
+    for (size_t i = 0; i < 40; i++)
+        test.shove_back(i % 3 ? T(i) : T(-1));
+    std::vector<T> expected(test.begin(), test.end());
+    bool           test_ok = true;
+    test_ok &=
+        stack_vector::count(test, needle) == size_t(std::count(expected.begin(), expected.end(), needle));
+    test_ok &= stack_vector::find(test, needle) - test.begin() ==
+               std::find(expected.begin(), expected.end(), needle) - expected.begin();
+    test_ok &= std::erase(test, needle) == std::erase(expected, needle);
+    test_ok &= std::equal(test.begin(), test.end(), expected.begin(), expected.end());
     return test_ok;
 }
 
+// sort, partial_sort and nth_element against std::sort, sizes cover the sorting networks, insertion sort and
+// pdqsort, on shuffled, sorted, reversed and few distinct values
+template <typename T, size_t N, typename Compare> bool sort_test(Compare comp) {
+    bool     test_ok = true;
+    unsigned state   = 7;
+    for (size_t len = 0; len <= N; len++) {
+        for (int pattern = 0; pattern < 4; pattern++) {
+            stack_vector::stack_vector<T, N> test;
+            for (size_t i = 0; i < len; i++) {
+                state = state * 1103515245u + 12345u;
+                const unsigned value =
+                    pattern == 0 ? state >> 8 : pattern == 3 ? (state >> 8) % 3 : unsigned(i);
+                if constexpr (std::is_same_v<T, std::string>)
+                    test.shove_back(std::to_string(value));
+                else
+                    test.shove_back(T(value));
+            }
+            if (pattern == 2)
+                std::reverse(test.begin(), test.end());
+            std::vector<T> expected(test.begin(), test.end());
+            std::sort(expected.begin(), expected.end(), comp);
+
+            const size_t                     k = len ? (state >> 4) % len : 0;
+            stack_vector::stack_vector<T, N> nth_test = test;
+            nth_test.nth_element(nth_test.begin() + k, comp);
+            if (len) {
+                test_ok &= !comp(nth_test[k], expected[k]) && !comp(expected[k], nth_test[k]);
+                for (size_t i = 0; i < len; i++)
+                    test_ok &= i < k ? !comp(nth_test[k], nth_test[i]) : !comp(nth_test[i], nth_test[k]);
+            }
+            stack_vector::stack_vector<T, N> top_test = test;
+            top_test.partial_sort(top_test.begin() + k, comp);
+            test_ok &= std::equal(top_test.begin(), top_test.begin() + k, expected.begin());
+            test_ok &=
+                std::is_permutation(top_test.begin(), top_test.end(), expected.begin(), expected.end());
+
+            test.sort(comp);
+            test_ok &= std::equal(test.begin(), test.end(), expected.begin(), expected.end());
+        }
+    }
+    return test_ok;
+}
+
+// ordered by key alone, equal keys with different payloads must all survive
+struct keyed {
+    int key;
+    int payload;
+
+    friend bool operator==(const keyed &, const keyed &) = default;
+};
+
 int main() {
     if (!constexpr_test()) {
         std::cout << "constexpr test failed!\n";
@@ -69,7 +323,7 @@ int main() {
     }
     for (size_t i = 0; i < test.capacity(); i++) {
         assert(test[i] == test.begin()[i] && "iterator value != ptr value");
-        assert(test[i] == i && "iterator value != assigned value!");
+        assert(test[i] == int(i) && "iterator value != assigned value!");
     }
     assert(test.size() == test.capacity() && "size != capacity");
 
@@ -90,8 +344,13 @@ int main() {
     assert(test_1.size() == (5) && "intializer list constructor failed");
     for (size_t i = 0; i < test_1.size(); i++) {
         assert(test_1[i] == test_1.begin()[i] && "iterator value != ptr value");
-        assert(test_1[i] == (i + 5) && "iterator value != assigned value");
+        assert(test_1[i] == int(i + 5) && "iterator value != assigned value");
     }
+    // a full stack_vector can still be assigned anything that fits on its own
+    const int replacement[] = {1, 2, 3};
+    test_1.assign(replacement, replacement + 3);
+    assert(test_1.size() == 3 && test_1[0] == 1 && test_1[2] == 3 && "assign should replace every element");
+    test_1 = {5, 6, 7, 8, 9};
     for (const auto &int_val : test_1) {
         output += std::to_string(int_val) + "\n";
     }
@@ -106,7 +365,7 @@ int main() {
     output += "___\n";
     test_1.insert(test_1.begin() + 2, {8, 9});
     for (size_t i = 2; i < 4; i++) {
-        assert(test_1[i] == (i + 6) && "iterator value != ptr value");
+        assert(test_1[i] == int(i + 6) && "iterator value != ptr value");
     }
     for (const auto &int_val : test_1) {
         output += std::to_string(int_val) + "\n";
@@ -150,7 +409,7 @@ int main() {
     }
 
     output += "___\n";
-    size_t removed_count = std::erase(erase_test, 1);
+    [[maybe_unused]] size_t removed_count = std::erase(erase_test, 1);
     assert(removed_count == 1 && "std::erase test failed!");
     assert(erase_test.size() == append_test.size() - 4 && "std::erase test failed!");
 
@@ -180,6 +439,301 @@ int main() {
         output += std::to_string(int_val) + "\n";
     }
 
+    output += "___\n";
+    stack_vector::stack_vector<int, 5, stack_vector::size_layout::_after> after_test = {1, 2, 3};
+    assert(after_test.size() == 3 && "size after layout intializer list constructor failed");
+    assert((void *)after_test.data() == (void *)&after_test && "size after layout must start with elements");
+    after_test.insert(after_test.begin() + 1, 4);
+    after_test.erase(after_test.begin());
+    assert(after_test.size() == 3 && after_test[0] == 4 && "size after layout insert / erase failed");
+    for (const auto &int_val : after_test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    output += "___\n";
+    // large trivially copyable stack_vectors copy only live elements and moves leave the source alone
+    stack_vector::stack_vector<int, 1024> big_test = {1, 2, 3};
+    stack_vector::stack_vector<int, 1024> big_copy = big_test;
+    stack_vector::stack_vector<int, 1024> big_move = std::move(big_test);
+    assert(big_copy == big_move && big_test.size() == 3 && "trivially copyable copy / move failed");
+    big_copy.shove_back(4);
+    big_copy.swap(big_move);
+    assert(big_copy.size() == 3 && big_move.size() == 4 && big_move[3] == 4 && "trivial swap failed");
+
+    stack_vector::stack_vector<std::string, 5> string_test   = {"a", "b", "c"};
+    stack_vector::stack_vector<std::string, 5> string_test_1 = {"d"};
+    string_test.swap(string_test_1);
+    assert(string_test.size() == 1 && string_test[0] == "d" && "non trivial swap failed");
+    assert(string_test_1.size() == 3 && string_test_1[2] == "c" && "non trivial swap failed");
+    for (const auto &str_val : string_test_1) {
+        output += str_val + "\n";
+    }
+
+    output += "___\n";
+    // trivially relocatable, but not trivially copyable
+    stack_vector::stack_vector<std::unique_ptr<int>, 8> ptr_test;
+    for (int i = 0; i < 4; i++) {
+        ptr_test.emplace_back(std::make_unique<int>(i));
+    }
+    ptr_test.emplace(ptr_test.begin() + 1, std::make_unique<int>(10));
+    ptr_test.insert(ptr_test.begin(), std::make_unique<int>(11));
+    assert(ptr_test.size() == 6 && *ptr_test[0] == 11 && *ptr_test[2] == 10 && *ptr_test[5] == 3 &&
+           "relocating emplace failed");
+    ptr_test.erase(ptr_test.begin() + 2);
+    ptr_test.erase(ptr_test.begin(), ptr_test.begin() + 2);
+    assert(ptr_test.size() == 3 && *ptr_test[0] == 1 && *ptr_test[2] == 3 && "relocating erase failed");
+    stack_vector::stack_vector<std::unique_ptr<int>, 8> ptr_test_1 = std::move(ptr_test);
+    assert(ptr_test.empty() && ptr_test_1.size() == 3 && "relocating move failed");
+    ptr_test.emplace_back(std::make_unique<int>(20));
+    ptr_test.swap(ptr_test_1);
+    assert(ptr_test.size() == 3 && ptr_test_1.size() == 1 && *ptr_test_1[0] == 20 && *ptr_test[0] == 1 &&
+           "relocating swap failed");
+    for (const auto &ptr_val : ptr_test) {
+        output += std::to_string(*ptr_val) + "\n";
+    }
+
+    output += "___\n";
+    stack_vector::stack_vector<int, 8> fill_test = {1, 2, 3};
+    fill_test.insert(fill_test.begin() + 1, 3, fill_test[0]);
+    assert(fill_test.size() == 6 && fill_test[1] == 1 && fill_test[3] == 1 && fill_test[4] == 2 &&
+           "insert count test failed");
+    fill_test.insert(fill_test.begin(), 5, 0);
+    assert(fill_test.size() == 6 && "insert past capacity should noop");
+    for (const auto &int_val : fill_test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    output += "___\n";
+    // every insert opens its gap once, checked against std::vector, aliasing arguments included
+    stack_vector::stack_vector<std::string, 32> gap_test = {"a", "b", "c", "d"};
+    std::vector<std::string>                    gap_model(gap_test.begin(), gap_test.end());
+    gap_test.insert(gap_test.begin() + 1, 3, gap_test[3]);
+    gap_model.insert(gap_model.begin() + 1, 3, gap_model[3]);
+    gap_test.insert(gap_test.begin(), gap_test.back());
+    gap_model.insert(gap_model.begin(), gap_model.back());
+    gap_test.emplace(gap_test.begin() + 2, 5, 'e');
+    gap_model.emplace(gap_model.begin() + 2, 5, 'e');
+    const std::string long_string(40, 'f');
+    gap_test.insert(gap_test.begin() + 7, long_string);
+    gap_model.insert(gap_model.begin() + 7, long_string);
+    const std::vector<std::string> gap_source(gap_model.begin(), gap_model.begin() + 6);
+    gap_test.insert(gap_test.begin() + 3, gap_source.begin(), gap_source.end());
+    gap_model.insert(gap_model.begin() + 3, gap_source.begin(), gap_source.end());
+    std::istringstream words("g h i");
+    gap_test.insert(gap_test.begin() + 1, std::istream_iterator<std::string>(words),
+                    std::istream_iterator<std::string>());
+    gap_model.insert(gap_model.begin() + 1, {"g", "h", "i"});
+    assert(std::equal(gap_test.begin(), gap_test.end(), gap_model.begin(), gap_model.end()) &&
+           "non trivial inserts disagree with std::vector");
+
+    stack_vector::stack_vector<int, 12> gap_int_test = {1, 2, 3, 4};
+    std::istringstream                  numbers("7 8 9 10 11 12 13 14 15");
+    gap_int_test.insert(gap_int_test.begin() + 1, std::istream_iterator<int>(numbers),
+                        std::istream_iterator<int>());
+    [[maybe_unused]] const int gap_int_expected[] = {1, 7, 8, 9, 10, 11, 12, 13, 14, 2, 3, 4};
+    assert(std::equal(gap_int_test.begin(), gap_int_test.end(), gap_int_expected, gap_int_expected + 12) &&
+           "an input range should insert what fits");
+
+    // a throwing copy closes the gap again
+    stack_vector::stack_vector<copy_throws, 8> throw_test;
+    for (const char *value : {"p", "q", "r"})
+        throw_test.emplace_back(value);
+    const copy_throws thrower("t", true);
+    [[maybe_unused]] bool threw = false;
+    try {
+        throw_test.insert(throw_test.begin() + 1, 2, thrower);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw && throw_test.size() == 3 && throw_test[0].value == "p" && throw_test[1].value == "q" &&
+           throw_test[2].value == "r" && "a failed insert should leave the elements as they were");
+
+    // so does a throwing conversion from the source range, even for a trivially copyable T
+    stack_vector::stack_vector<int, 8> convert_throw_test{10, 20, 30};
+    const std::vector<converts_throws> convert_source{{1}, {2}, {3}};
+    threw = false;
+    try {
+        convert_throw_test.insert(convert_throw_test.begin() + 1, convert_source.begin(), convert_source.end());
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    assert(threw && convert_throw_test.size() == 3 && convert_throw_test[0] == 10 && convert_throw_test[1] == 20 &&
+           convert_throw_test[2] == 30 && "a failed converting insert should leave the elements as they were");
+    for (const auto &string_val : gap_test) {
+        output += string_val + "\n";
+    }
+
+    output += "___\n";
+    // writing straight into the spare capacity
+    stack_vector::stack_vector<char, 16> tail_test = {'a', 'b'};
+    std::span<char>                      spare     = tail_test.spare_capacity();
+    assert(spare.size() == 14 && spare.data() == tail_test.end() && "spare capacity span is wrong");
+    std::memcpy(spare.data(), "cdef", 4);
+    tail_test.commit(4);
+    assert(tail_test.size() == 6 && tail_test[5] == 'f' && "commit failed");
+    tail_test.resize_and_overwrite(10, [](char *data, [[maybe_unused]] size_t count) {
+        assert(count == 10 && data[0] == 'a' && "resize_and_overwrite passed the wrong range");
+        data[6] = 'g';
+        return size_t(7);
+    });
+    assert(tail_test.size() == 7 && tail_test.back() == 'g' && "resize_and_overwrite failed");
+    tail_test.resize_default_init(3);
+    assert(tail_test.size() == 3 && tail_test.back() == 'c' && "resize_default_init shrink failed");
+    tail_test.resize_default_init(5);
+    assert(tail_test.size() == 5 && "resize_default_init grow failed");
+    stack_vector::stack_vector<std::string, 4> default_init_test;
+    default_init_test.resize_default_init(3);
+    assert(default_init_test.size() == 3 && default_init_test[2].empty() && "resize_default_init failed");
+    default_init_test.resize_default_init(8);
+    assert(default_init_test.size() == 3 && "resize_default_init past capacity should noop");
+    for (size_t i = 0; i < 3; i++) {
+        output += std::string(1, tail_test[i]) + "\n";
+    }
+
+    output += "___\n";
+    stack_vector::stack_vector<int, 8> resize_test(3);
+    assert(resize_test.size() == 3 && resize_test[2] == 0 && "count constructor failed");
+    resize_test[0] = 1;
+    resize_test.resize(6, resize_test[0]);
+    assert(resize_test.size() == 6 && resize_test[1] == 0 && resize_test[5] == 1 && "resize with value failed");
+    resize_test.resize(2);
+    resize_test.resize(4);
+    assert(resize_test.size() == 4 && resize_test[0] == 1 && resize_test[3] == 0 && "resize failed");
+    resize_test.resize(9);
+    assert(resize_test.size() == 4 && "resize past capacity should noop");
+    stack_vector::stack_vector<std::string, 4> string_resize_test(2);
+    string_resize_test.resize(4, "x");
+    string_resize_test.resize(3);
+    assert(string_resize_test.size() == 3 && string_resize_test[0].empty() && string_resize_test[2] == "x" &&
+           "non trivial resize failed");
+    for (const auto &int_val : resize_test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    output += "___\n";
+    // bulk and unordered erases, bulk inserts, on relocatable and non relocatable T's
+    stack_vector::stack_vector<int, 16> bulk_test = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const size_t                  expired[]    = {0, 3, 4, 9};
+    [[maybe_unused]] const size_t erased_count = bulk_test.erase_indices(expired);
+    assert(erased_count == 4 && bulk_test.size() == 6 && bulk_test[0] == 1 && bulk_test[2] == 5 &&
+           bulk_test.back() == 8 && "erase_indices failed");
+    [[maybe_unused]] const auto swapped_in = bulk_test.swap_erase(bulk_test.begin() + 1);
+    assert(*swapped_in == 8 && bulk_test.size() == 5 && bulk_test[1] == 8 && "swap_erase failed");
+    bulk_test.erase_unordered(bulk_test.begin(), bulk_test.begin() + 2); // 1, 8, 5, 6, 7 -> 6, 7, 5
+    assert(bulk_test.size() == 3 && bulk_test[0] == 6 && bulk_test[1] == 7 && bulk_test[2] == 5 &&
+           "erase_unordered failed");
+    const size_t                gaps[]      = {0, 2, 2, 3};
+    const int                   values[]    = {10, 20, 21, 30};
+    [[maybe_unused]] const bool bulk_placed = bulk_test.insert_many(gaps, values);
+    assert(bulk_placed && "insert_many failed");
+    [[maybe_unused]] const int inserted[] = {10, 6, 7, 20, 21, 5, 30};
+    assert(std::equal(bulk_test.begin(), bulk_test.end(), inserted, inserted + 7) && "insert_many misplaced");
+    stack_vector::stack_vector<int, 4> bulk_full_test = {1, 2, 3};
+    [[maybe_unused]] const bool        full_placed    = bulk_full_test.insert_many(gaps, values);
+    assert(!full_placed && bulk_full_test.size() == 3 && "insert_many past the capacity should refuse");
+
+    stack_vector::stack_vector<std::string, 16> bulk_string_test;
+    for (int i = 0; i < 10; i++)
+        bulk_string_test.push_back(std::to_string(i) + std::string(20, 's'));
+    const size_t                  string_expired[]    = {1, 2, 8};
+    [[maybe_unused]] const size_t string_erased_count = bulk_string_test.erase_indices(string_expired);
+    assert(string_erased_count == 3 && bulk_string_test[1][0] == '3' && bulk_string_test[6][0] == '9' &&
+           "non trivial erase_indices failed");
+    bulk_string_test.swap_erase(bulk_string_test.begin());
+    bulk_string_test.erase_unordered(bulk_string_test.begin() + 4, bulk_string_test.end());
+    assert(bulk_string_test.size() == 4 && bulk_string_test[0][0] == '9' &&
+           "non trivial unordered erase failed");
+    const size_t                string_gaps[]   = {0, 4, 4};
+    const std::string           string_values[] = {"a", "b", "c"};
+    [[maybe_unused]] const bool string_placed   = bulk_string_test.insert_many(string_gaps, string_values);
+    assert(string_placed && bulk_string_test.size() == 7 && bulk_string_test[0] == "a" &&
+           bulk_string_test[1][0] == '9' && bulk_string_test[5] == "b" && bulk_string_test[6] == "c" &&
+           "non trivial insert_many failed");
+    // a throwing copy destroys what was already built past the end and keeps the old size
+    stack_vector::stack_vector<copy_throws, 8> bulk_throw_test;
+    for (const char *value : {"p", "q", "r"})
+        bulk_throw_test.emplace_back(value);
+    const size_t          throw_gaps[]   = {3, 3};
+    const copy_throws     throw_values[] = {copy_throws("t", true), copy_throws(std::string(40, 'u'))};
+    [[maybe_unused]] bool bulk_threw     = false;
+    try {
+        bulk_throw_test.insert_many(throw_gaps, throw_values);
+    } catch (const std::runtime_error &) {
+        bulk_threw = true;
+    }
+    assert(bulk_threw && bulk_throw_test.size() == 3 && bulk_throw_test[0].value == "p" &&
+           bulk_throw_test[2].value == "r" && "a failed insert_many should keep the old size");
+    {
+        stack_vector::stack_vector<relocatable_throws, 8> reloc_test;
+        for (int i = 0; i < 4; i++)
+            reloc_test.emplace_back(i);
+        const size_t             reloc_gaps[]   = {1, 3};
+        const relocatable_throws reloc_values[] = {relocatable_throws(10, true), relocatable_throws(11)};
+        [[maybe_unused]] const int live_before  = relocatable_throws::live;
+        bulk_threw                              = false;
+        try {
+            reloc_test.insert_many(reloc_gaps, reloc_values);
+        } catch (const std::runtime_error &) {
+            bulk_threw = true;
+        }
+        assert(bulk_threw && reloc_test.size() == 4 && relocatable_throws::live == live_before &&
+               "a failed relocatable insert_many should keep every element alive");
+    }
+    assert(relocatable_throws::live == 0 && "relocatable_throws leaked");
+    for (const auto &int_val : bulk_test) {
+        output += std::to_string(int_val) + "\n";
+    }
+
+    output += "___\n";
+    const auto supported = stack_vector::simd::supported_isa();
+    for (auto level : {stack_vector::simd::isa_level::_scalar, stack_vector::simd::isa_level::_sse2,
+                       stack_vector::simd::isa_level::_avx2}) {
+        if (level > supported)
+            continue;
+        stack_vector::simd::active_isa = level;
+        assert(kernel_test<int8_t>() && kernel_test<uint16_t>() && kernel_test<int32_t>() &&
+               kernel_test<uint64_t>() && kernel_test<float>() && kernel_test<double>() &&
+               "arithmetic kernels disagree with the std algorithms");
+        assert(mixed_kernel_test<uint32_t>(-1) && mixed_kernel_test<int32_t>(0xffffffffu) &&
+               mixed_kernel_test<uint8_t>(-1) && mixed_kernel_test<int8_t>(255) &&
+               mixed_kernel_test<int64_t>(uint64_t(-1)) && mixed_kernel_test<uint16_t>(int64_t(-1)) &&
+               mixed_kernel_test<uint64_t>(-1) && mixed_kernel_test<int16_t>(uint32_t(-1)) &&
+               "mixed sign needles should compare like ==");
+    }
+    stack_vector::simd::active_isa = supported;
+    stack_vector::stack_vector<uint8_t, 16> id_test = {1, 200, 3, 200, 5};
+    assert(stack_vector::count(id_test, 200) == 2 && stack_vector::count(id_test, 456) == 0 &&
+           "mixed integer kernels failed");
+    [[maybe_unused]] const size_t missing_erased = std::erase(id_test, 456);
+    [[maybe_unused]] const size_t id_erased      = std::erase(id_test, 200);
+    assert(missing_erased == 0 && id_erased == 2 && id_test.size() == 3 && "mixed integer erase failed");
+    stack_vector::stack_vector<float, 8> nan_test = {0.0f, -0.0f, std::numeric_limits<float>::quiet_NaN()};
+    assert(stack_vector::count(nan_test, 0.0f) == 2 && !stack_vector::contains(nan_test, nan_test[2]) &&
+           "float kernels must compare like ==");
+    for (const auto &id : id_test) {
+        output += std::to_string(id) + "\n";
+    }
+
+    output += "___\n";
+    assert((sort_test<int, 16>(std::less<>{}) && sort_test<int, 200>(std::less<>{}) &&
+            sort_test<uint8_t, 40>(std::greater<>{}) && sort_test<double, 200>(std::less<double>{}) &&
+            sort_test<std::string, 100>(std::less<>{})) &&
+           "sort disagrees with std::sort");
+    auto by_key = [](const keyed &left, const keyed &right) { return left.key < right.key; };
+    stack_vector::stack_vector<keyed, 64> keyed_test;
+    for (int i = 0; i < 64; i++)
+        keyed_test.shove_back(keyed{(i * 13) % 5, i});
+    keyed_test.sort(by_key);
+    assert(std::is_sorted(keyed_test.begin(), keyed_test.end(), by_key) && "keyed sort failed");
+    for (int i = 0; i < 64; i++)
+        assert(std::count(keyed_test.begin(), keyed_test.end(), keyed{(i * 13) % 5, i}) == 1 &&
+               "sort lost an element with an equal key");
+    stack_vector::stack_vector<float, 16> scores = {0.5f, 0.9f, 0.1f, 0.7f, 0.3f, 0.8f};
+    scores.partial_sort(scores.begin() + 3, std::greater<>{});
+    for (const auto &score : scores) {
+        output += std::to_string(score) + "\n";
+    }
+
     std::cout << output;
 
     return 0;
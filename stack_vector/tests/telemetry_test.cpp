@@ -0,0 +1,166 @@
+// telemetry_test.cpp : peak sizes, sizes at destruction and overflow counts per stack_vector<T, N>
+//
+#define STACK_VECTOR_TELEMETRY 1
+#include "stack_string.h"
+#include "stack_vector.h"
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// the statistics of stack_vector<T, N>, or nothing if none was used yet
+template <typename T, size_t N> stack_vector::telemetry::statistics stats_of() {
+    const std::string type(stack_vector::telemetry::details::type_name<T>());
+    for (auto &stats : stack_vector::telemetry::snapshot()) {
+        if (stats.type == type && stats.capacity == N)
+            return stats;
+    }
+    return {};
+}
+// the bucket a stack_vector<T, N> of this size is counted in at destruction
+template <size_t N> size_t bucket_of(size_t size) {
+    return size * stack_vector::telemetry::buckets / (N + 1);
+}
+
+// telemetry stays out of constant expressions
+constexpr int constexpr_sum() {
+    stack_vector::stack_vector<int, 8> test = {1, 2, 3};
+    test.push_back(4);
+    int sum = 0;
+    for (int value : test)
+        sum += value;
+    return sum;
+}
+static_assert(constexpr_sum() == 10);
+
+int main() {
+    std::string output = "";
+
+    static_assert(sizeof(stack_vector::stack_vector<uint8_t, 15>) == 16 &&
+                  "tracking the size should not make it larger");
+
+    {
+        stack_vector::stack_vector<int, 16> test;
+        for (int i = 0; i < 12; i++)
+            test.push_back(i);
+        test.clear();
+        test.push_back(1);
+    }
+    auto stats = stats_of<int, 16>();
+    assert(stats.peak == 12 && stats.destroyed == 1 && stats.overflows == 0 &&
+           stats.sizes[bucket_of<16>(1)] == 1 &&
+           "the peak should survive a clear and the final size land in its bucket");
+    // 17 sizes in 16 buckets, the first one holds two
+    assert(stats.bucket_range(0).first == 0 && stats.bucket_range(0).second == 1 &&
+           stats.bucket_range(1).first == 2 && stats.bucket_range(1).second == 2 &&
+           stats.bucket_range(15).first == 16 && stats.bucket_range(15).second == 16 &&
+           "bucket ranges should cover [0, N] without gaps");
+
+    // every kind of insert that doesn't fit counts, whatever the error handling does about it
+    {
+        stack_vector::stack_vector<int, 16> test(16, 0);
+        const std::vector<int> more(4, 1);
+        test.push_back(1);
+        test.emplace(test.begin(), 2);
+        test.insert(test.begin(), more.begin(), more.end());
+        test.insert(test.begin(), size_t(3), 3);
+        test.append(more.begin(), more.end());
+        test.append(size_t(0), 4);
+        test.resize(20);
+        assert(test.size() == 16 && "an overflowing stack_vector should keep its elements");
+    }
+    stats = stats_of<int, 16>();
+    assert(stats.peak == 16 && stats.destroyed == 2 && stats.overflows == 6 &&
+           stats.sizes[bucket_of<16>(16)] == 1 && "overflows should be counted once each");
+
+    // a single pass insert keeps what fit in place and counts one overflow, appending nothing counts none
+    {
+        stack_vector::stack_vector<int, 8> test = {1, 2, 3, 4, 5, 6};
+        std::istringstream                 numbers("7 8 9");
+        test.insert(test.begin() + 1, std::istream_iterator<int>(numbers), std::istream_iterator<int>());
+        test.append(size_t(0), 10);
+        test.append(size_t(1), 10);
+        [[maybe_unused]] const int expected[] = {1, 7, 8, 2, 3, 4, 5, 6};
+        assert(std::equal(test.begin(), test.end(), expected, expected + 8) &&
+               "a single pass insert should rotate what it took into place");
+    }
+    [[maybe_unused]] const auto single_pass_stats = stats_of<int, 8>();
+    assert(single_pass_stats.overflows == 2 && "only the inserts that didn't fit should count");
+
+    // a stack_string's overflows count against the stack_vector<char, N + 1> holding its chars
+    {
+        stack_vector::stack_string<4> test = "ab";
+        test.append("xyz");
+        test.append(size_t(3), 'z');
+        test.push_back('c');
+        test.push_back('d');
+        assert(test == "abcd" && "an overflowing stack_string should keep its chars");
+    }
+    [[maybe_unused]] const auto string_overflow_stats = stats_of<char, 5>();
+    assert(string_overflow_stats.overflows == 2 && string_overflow_stats.peak == 4 &&
+           "stack_string overflows should be counted");
+
+    // swapping exchanges the sizes without counting a destruction
+    {
+        stack_vector::stack_vector<int, 4> left = {1, 2, 3};
+        stack_vector::stack_vector<int, 4> right = {4};
+        left.swap(right);
+        std::swap(left, right);
+        left.swap(right);
+        assert(left.size() == 1 && right.size() == 3 && "swap should exchange the sizes");
+    }
+    [[maybe_unused]] const auto swap_stats = stats_of<int, 4>();
+    assert(swap_stats.destroyed == 2 && swap_stats.peak == 3 && swap_stats.sizes[bucket_of<4>(1)] == 1 &&
+           swap_stats.sizes[bucket_of<4>(3)] == 1 && "swap should not count a destruction");
+
+    // copies and temporaries are stack_vectors too
+    {
+        stack_vector::stack_vector<std::string, 4> strings = {"a", "b", "c"};
+        auto copy = strings;
+        copy.pop_back();
+    }
+    const auto string_stats = stats_of<std::string, 4>();
+    assert(string_stats.peak == 3 && string_stats.destroyed == 2 &&
+           string_stats.sizes[bucket_of<4>(2)] == 1 && string_stats.sizes[bucket_of<4>(3)] == 1 &&
+           "copies should be counted");
+
+    // counters are shared between threads
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 1000; i++) {
+                stack_vector::stack_vector<uint16_t, 255> test;
+                test.resize(size_t((i + t) % 256));
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    const auto wide_stats = stats_of<uint16_t, 255>();
+    size_t     counted    = 0;
+    for (auto count : wide_stats.sizes)
+        counted += count;
+    assert(wide_stats.peak == 255 && wide_stats.destroyed == 4000 && counted == 4000 &&
+           wide_stats.overflows == 0 && "counters lost updates between threads");
+
+    const std::string json = stack_vector::telemetry::report_json();
+    assert(json.front() == '[' && json.back() == ']' &&
+           json.find("\"capacity\":16,\"peak\":16,\"destroyed\":2,\"overflows\":6") != std::string::npos &&
+           "json report is missing a stack_vector");
+
+    stack_vector::telemetry::reset();
+    stats = stats_of<int, 16>();
+    assert(stats.peak == 0 && stats.destroyed == 0 && stats.overflows == 0 &&
+           stats.sizes[bucket_of<16>(16)] == 0 && "reset should zero every counter");
+    {
+        stack_vector::stack_vector<int, 16> test = {1, 2, 3};
+    }
+
+    output += stack_vector::telemetry::report_text();
+
+    std::cout << output;
+
+    return 0;
+}